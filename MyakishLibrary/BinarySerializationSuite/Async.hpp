@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+
+#include <MyakishLibrary/BinarySerializationSuite/BinarySerializationSuite.hpp>
+
+#include <MyakishLibrary/Streams/Async.hpp>
+
+namespace myakish::binary_serialization_suite
+{
+    // Whole-buffer loaders: the full payload is awaited into memory, then decoded in one go on whichever thread resumes.
+    // Reads and decoding do not overlap, so peak memory is the payload size; attributes must outlive the task.
+    // A short read leaves the attribute untouched and the stream invalid
+    struct ParseBufferedAsyncFunctor : functional::ExtensionMethod
+    {
+        template<streams::AsyncInputStream Stream, ParserConcept Parser, typename Attribute>
+        streams::Task<> operator()(Stream& in, Parser parser, Attribute& attribute, myakish::Size size) const
+        {
+            auto buffer = std::make_unique_for_overwrite<std::byte[]>(size);
+            co_await in.ReadAsync(buffer.get(), size);
+
+            if constexpr (requires { in.Valid(); }) if (!in.Valid()) co_return;
+
+            parser(streams::ContiguousStream<true>(buffer.get(), size), attribute);
+        }
+
+        template<streams::AsyncInputStream Stream, ParserConcept Parser, typename Attribute> requires streams::SizedStream<Stream>
+        streams::Task<> operator()(Stream& in, Parser parser, Attribute& attribute) const
+        {
+            return operator()(in, std::move(parser), attribute, streams::Length(in));
+        }
+
+        template<streams::AsyncInputStream Stream, MonomorphicParserConcept Parser> requires streams::SizedStream<Stream>
+        streams::Task<typename ParserAttribute<Parser>::type> operator()(Stream& in, Parser parser) const
+        {
+            typename ParserAttribute<Parser>::type synthesized{};
+            co_await operator()(in, std::move(parser), synthesized, streams::Length(in));
+
+            co_return synthesized;
+        }
+    };
+    inline constexpr ParseBufferedAsyncFunctor ParseBufferedAsync;
+
+    // Encodes into memory first, then awaits a single write of the whole buffer
+    struct SerializeBufferedAsyncFunctor : functional::ExtensionMethod
+    {
+        template<streams::AsyncOutputStream Stream, ParserConcept Parser, typename Attribute>
+        streams::Task<> operator()(Stream& out, Parser parser, const Attribute& attribute) const
+        {
+            streams::BufferOutputStream buffer;
+            parser(buffer, attribute);
+
+            auto bytes = buffer.Release();
+            co_await out.WriteAsync(bytes.Data(), bytes.Length());
+        }
+    };
+    inline constexpr SerializeBufferedAsyncFunctor SerializeBufferedAsync;
+}
@@ -2,8 +2,10 @@
 #include <functional>
 #include <concepts>
 #include <array>
+#include <algorithm>
 #include <utility>
 #include <tuple>
+#include <string_view>
 #include <variant>
 
 #include <MyakishLibrary/Streams/Common.hpp>
@@ -223,6 +225,40 @@ namespace myakish::binary_serialization_suite
 
     namespace detail
     {
+        // Bytes a parser always writes, -1 when it depends on the value or on the stream
+        template<typename Parser>
+        inline constexpr myakish::Size EncodedSize = -1;
+
+        template<typename Parser>
+        inline constexpr myakish::Size EncodedSize<const Parser> = EncodedSize<Parser>;
+
+        template<>
+        inline constexpr myakish::Size EncodedSize<NoOpParser> = 0;
+
+        template<typename Type>
+        inline constexpr myakish::Size EncodedSize<TrivialParser<Type>> = std::same_as<Type, std::string_view> ? -1 : sizeof(Type);
+
+        template<typename Underlying, typename ...Projections>
+        inline constexpr myakish::Size EncodedSize<ProjectedParser<Underlying, Projections...>> = EncodedSize<Underlying>;
+
+        template<typename Parser, typename Stream>
+        concept EncodableInPlace = EncodedSize<Parser> > 0 && streams::TransactionalStream<Stream> && !streams::InputStream<Stream> && !streams::ValueStream<Stream>;
+
+        // Upper bound on one acquired region when a repetition is encoded in place; always at least one element
+        inline constexpr myakish::Size EncodeInPlaceChunk = 1 << 16;
+
+        // One bounds check for the whole region; the parsers then write straight into the destination
+        template<typename Stream, typename Encoder>
+        void EncodeInPlace(Stream&& stream, myakish::Size size, Encoder&& encode)
+        {
+            auto region = streams::Acquire(stream, size);
+
+            streams::WriteOnlyWrapper<streams::ContiguousStream<false>> encoder(streams::ContiguousStream<false>(region.data(), size));
+            encode(encoder);
+
+            streams::Commit(stream, size);
+        }
+
         template<ParserConcept First, ParserConcept Second>
         struct SequenceParserAttribute : meta::Undefined {};
 
@@ -243,11 +279,28 @@ namespace myakish::binary_serialization_suite
         template<streams::Stream Stream, typename ...Attributes>
         void operator()(Stream&& stream, Attributes&&... attributes) const
         {
-            f(stream, attributes...);
-            s(stream, attributes...);
+            if constexpr (detail::EncodableInPlace<SequenceParser, Stream>)
+            {
+                detail::EncodeInPlace(stream, detail::EncodedSize<SequenceParser>, [&](auto& encoder)
+                    {
+                        f(encoder, attributes...);
+                        s(encoder, attributes...);
+                    });
+            }
+            else
+            {
+                f(stream, attributes...);
+                s(stream, attributes...);
+            }
         }
     };
 
+    namespace detail
+    {
+        template<typename First, typename Second>
+        inline constexpr myakish::Size EncodedSize<SequenceParser<First, Second>> = EncodedSize<First> >= 0 && EncodedSize<Second> >= 0 ? EncodedSize<First> + EncodedSize<Second> : -1;
+    }
+
     template<ParserConcept First, ParserConcept Second>
     constexpr auto operator>>(First f, Second s)
     {
@@ -392,6 +445,21 @@ namespace myakish::binary_serialization_suite
 
     
     
+    namespace detail
+    {
+        template<typename Parser, typename Range>
+        concept BulkTrivialRange =
+            std::ranges::contiguous_range<Range> &&
+            std::ranges::sized_range<Range> &&
+            std::same_as<Parser, TrivialParser<std::ranges::range_value_t<Range>>>;
+
+        template<typename Parser, typename Range>
+        concept BulkTrivialResizableRange = BulkTrivialRange<Parser, Range> && requires(Range range, std::size_t size)
+        {
+            range.resize(size);
+        };
+    }
+    
     template<ParserConcept Parser, typename StoredSize = myakish::Size>
     struct RepeatParser : ParserBase
     {
@@ -405,14 +473,22 @@ namespace myakish::binary_serialization_suite
         {
             auto size = Trivial<StoredSize>.Parse(in);
 
-            auto Parse = [&](auto _)
-                {
-                    std::ranges::range_value_t<AttributeRange> synthesized{};
-                    parser(in, synthesized);
-                    return synthesized;
-                };
+            if constexpr (detail::BulkTrivialResizableRange<Parser, std::remove_cvref_t<AttributeRange>>)
+            {
+                attribute.resize(size);
+                streams::ReadArray(in, std::ranges::data(attribute), static_cast<myakish::Size>(size));
+            }
+            else
+            {
+                auto Parse = [&](auto _)
+                    {
+                        std::ranges::range_value_t<AttributeRange> synthesized{};
+                        parser(in, synthesized);
+                        return synthesized;
+                    };
 
-            attribute = std::views::iota(StoredSize(0), size) | std::views::transform(Parse) | std::ranges::to<std::remove_cvref_t<AttributeRange>>();
+                attribute = std::views::iota(StoredSize(0), size) | std::views::transform(Parse) | std::ranges::to<std::remove_cvref_t<AttributeRange>>();
+            }
         }
 
         template<streams::OutputStream Stream, std::ranges::range AttributeRange>
@@ -420,7 +496,30 @@ namespace myakish::binary_serialization_suite
         {
             out | streams::WriteAs<StoredSize>[std::ranges::size(attribute)];
 
-            std::ranges::for_each(attribute, functional::Invoke[parser, out, functional::Arg<0>]);
+            if constexpr (detail::BulkTrivialRange<Parser, std::remove_cvref_t<AttributeRange>>)
+            {
+                streams::WriteArray(out, std::ranges::data(attribute), static_cast<myakish::Size>(std::ranges::size(attribute)));
+            }
+            else if constexpr (detail::EncodableInPlace<Parser, Stream> && std::ranges::sized_range<AttributeRange>)
+            {
+                constexpr auto PerChunk = std::max<myakish::Size>(1, detail::EncodeInPlaceChunk / detail::EncodedSize<Parser>);
+
+                auto count = static_cast<myakish::Size>(std::ranges::size(attribute));
+                auto element = std::ranges::begin(attribute);
+
+                while (count > 0)
+                {
+                    auto chunk = std::min(count, PerChunk);
+
+                    detail::EncodeInPlace(out, chunk * detail::EncodedSize<Parser>, [&](auto& encoder)
+                        {
+                            for (auto i = chunk; i > 0; i--, ++element) parser(encoder, *element);
+                        });
+
+                    count -= chunk;
+                }
+            }
+            else std::ranges::for_each(attribute, functional::Invoke[parser, out, functional::Arg<0>]);
         }
     };
     template<typename StoredSize>
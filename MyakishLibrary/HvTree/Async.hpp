@@ -0,0 +1,104 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <MyakishLibrary/HvTree/HvTree.hpp>
+#include <MyakishLibrary/HvTree/Build.hpp>
+
+#include <MyakishLibrary/BinarySerializationSuite/Async.hpp>
+
+#include <MyakishLibrary/Streams/Async.hpp>
+
+namespace myakish::tree
+{
+    template<typename Type>
+    concept FetchableSource = requires(Type source)
+    {
+        { source.FetchAsync() } -> streams::Awaitable;
+    };
+
+    // copies share the fetched bytes, so a copy placed into a build expression sees the result of FetchAsync on the original
+    struct AsyncDataSource
+    {
+        streams::AsyncFileInputStream* in;
+        myakish::Size offset;
+        myakish::Size size;
+        std::shared_ptr<std::vector<std::byte>> data;
+
+        AsyncDataSource(streams::AsyncFileInputStream& in, myakish::Size offset, myakish::Size size) :
+            in(&in), offset(offset), size(size), data(std::make_shared<std::vector<std::byte>>()) {}
+
+        streams::Task<> FetchAsync() const
+        {
+            data->resize(size);
+            return in->ReadAtAsync(data->data(), size, offset);
+        }
+
+        void WriteData(streams::OutputStream auto&& out) const
+        {
+            streams::Write(out, data->data(), static_cast<myakish::Size>(data->size()));
+        }
+    };
+
+    struct AsyncDataFunctor : functional::ExtensionMethod
+    {
+        AsyncDataSource operator()(streams::AsyncFileInputStream& in, myakish::Size offset, myakish::Size size) const
+        {
+            return AsyncDataSource(in, offset, size);
+        }
+    };
+    inline constexpr AsyncDataFunctor AsyncData;
+
+
+    struct BuildAsyncFunctor : functional::ExtensionMethod
+    {
+        template<BuildSource Source, HandleConcept Handle, FetchableSource... Pending>
+        streams::Task<> operator()(Storage<Handle>& storage, Source source, Pending... pending) const
+        {
+            std::vector<streams::Task<>> fetches;
+            (fetches.push_back(pending.FetchAsync()), ...);
+
+            co_await streams::WhenAll(std::move(fetches));
+
+            Build(storage, source);
+        }
+
+        template<HasHandleType Source, FetchableSource... Pending>
+        streams::Task<Storage<typename HandleType<std::remove_cvref_t<Source>>::type>> operator()(Source source, Pending... pending) const
+        {
+            Storage<typename HandleType<std::remove_cvref_t<Source>>::type> storage{};
+            co_await operator()(storage, std::move(source), std::move(pending)...);
+
+            co_return storage;
+        }
+    };
+    inline constexpr BuildAsyncFunctor BuildAsync;
+
+
+    // Reads the whole serialized storage before decoding it
+    template<HandleConcept Handle>
+    struct LoadAsyncFunctor : functional::ExtensionMethod
+    {
+        template<streams::AsyncInputStream Stream> requires streams::SizedStream<Stream>
+        streams::Task<Storage<Handle>> operator()(Stream& in) const
+        {
+            Storage<Handle> storage{};
+            co_await binary_serialization_suite::ParseBufferedAsync(in, StorageParser<Handle>, storage);
+
+            co_return storage;
+        }
+    };
+    template<HandleConcept Handle>
+    inline constexpr LoadAsyncFunctor<Handle> LoadAsync;
+
+    struct StoreAsyncFunctor : functional::ExtensionMethod
+    {
+        template<streams::AsyncOutputStream Stream, HandleConcept Handle>
+        streams::Task<> operator()(Stream& out, const Storage<Handle>& storage) const
+        {
+            return binary_serialization_suite::SerializeBufferedAsync(out, StorageParser<Handle>, storage);
+        }
+    };
+    inline constexpr StoreAsyncFunctor StoreAsync;
+}
@@ -145,6 +145,12 @@ namespace myakish::tree
         inline constexpr static auto Parser = binary_serialization_suite::template Trivial<Trivial>;
     };
 
+    template<meta::TriviallyCopyableConcept Trivial>
+    struct AcquireTraits<std::vector<Trivial>>
+    {
+        inline constexpr static auto Parser = binary_serialization_suite::Repeat<>(binary_serialization_suite::template Trivial<Trivial>);
+    };
+
 
     template<HandleConcept StorageHandle>
     struct Storage
@@ -204,4 +210,25 @@ namespace myakish::tree
 
     template<HandleConcept Handle>
     using TreeHandle = Storage<Handle>::EntryHandle;
+
+
+    namespace detail
+    {
+        template<HandleConcept Handle>
+        consteval auto MakeHandleParser()
+        {
+            if constexpr (std::same_as<Handle, std::string>) return binary_serialization_suite::Repeat<>(binary_serialization_suite::template Trivial<char>);
+            else return binary_serialization_suite::template Trivial<Handle>;
+        }
+
+        template<HandleConcept Handle>
+        inline constexpr auto HandleParser = MakeHandleParser<Handle>();
+    }
+
+    template<HandleConcept Handle>
+    inline constexpr auto StorageParser = binary_serialization_suite::Repeat<>(
+        detail::HandleParser<Handle>[&Storage<Handle>::Entry::handle] >>
+        binary_serialization_suite::Repeat<>(binary_serialization_suite::template Trivial<std::byte>)[&Storage<Handle>::Entry::data] >>
+        binary_serialization_suite::Repeat<>(binary_serialization_suite::template Trivial<myakish::Size>)[&Storage<Handle>::Entry::childrenOffsets]
+    )[&Storage<Handle>::entries];
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <MyakishLibrary/HvTree/Parser/Parser.hpp>
+
+#include <MyakishLibrary/Streams/Checksum.hpp>
+#include <MyakishLibrary/Streams/Mapped.hpp>
+#include <MyakishLibrary/Streams/Segmented.hpp>
+
+#include <MyakishLibrary/Utility.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <random>
+#include <string_view>
+#include <system_error>
+#include <typeinfo>
+
+namespace myakish::tree::parse
+{
+    namespace detail
+    {
+        struct CacheHeader
+        {
+            inline constexpr static std::uint64_t ExpectedMagic = 0x31434856'4B53594Dull;
+            inline constexpr static std::uint64_t ExpectedVersion = 2;
+
+            std::uint64_t magic;
+            std::uint64_t version;
+            std::uint64_t key;
+            myakish::Size payloadSize;
+            std::uint64_t payloadChecksum;
+        };
+    }
+
+    // Entries carry an XXH64 of their payload, so truncated or corrupted files are rejected and reparsed.
+    // The directory is still trusted: an entry crafted with a matching checksum is deserialized as is
+    struct ParseCache
+    {
+        fs::path directory;
+        std::uint64_t salt;
+
+        ParseCache(fs::path directory, std::uint64_t salt = 0) : directory(std::move(directory)), salt(salt) {}
+
+        template<std::ranges::contiguous_range Range, ParserConcept... Parsers> requires boost::parser::parsable_range<Range> && std::same_as<std::ranges::range_value_t<Range>, char>
+        Storage<std::string> Parse(Range&& range, const Parsers... parsers) const
+        {
+            using ParserType = decltype(functional::RightFold(Chain, parsers...));
+
+            auto source = std::string_view(std::ranges::data(range), std::ranges::size(range));
+            auto key = HashCombine(HashCombine(Hash(source), Hash(typeid(ParserType).name())), salt);
+
+            auto path = directory / std::format("{:016x}.hvc", key);
+
+            if (auto cached = Load(path, key)) return std::move(*cached);
+
+            auto storage = parse::Parse(range, parsers...);
+            Store(path, key, storage);
+
+            return storage;
+        }
+
+        std::optional<Storage<std::string>> Load(const fs::path& path, std::uint64_t key) const
+        {
+            streams::MappedInputStream in(path);
+            if (!in.Valid() || in.Length() < static_cast<myakish::Size>(sizeof(detail::CacheHeader))) return std::nullopt;
+
+            auto header = in | streams::ReadTrivial<detail::CacheHeader>;
+
+            if (header.magic != detail::CacheHeader::ExpectedMagic ||
+                header.version != detail::CacheHeader::ExpectedVersion ||
+                header.key != key ||
+                header.payloadSize != streams::Length(in)) return std::nullopt;
+
+            streams::XxHash64 checksum;
+            checksum.Update(streams::Data(in), header.payloadSize);
+
+            if (checksum.Value() != header.payloadChecksum) return std::nullopt;
+
+            Storage<std::string> storage{};
+            StorageParser<std::string>(in, storage);
+
+            return storage;
+        }
+
+        void Store(const fs::path& path, std::uint64_t key, const Storage<std::string>& storage) const
+        {
+            std::error_code error;
+
+            fs::create_directories(directory, error);
+            if (error) return;
+
+            streams::GatherOutputStream out;
+
+            auto header = out.Write(sizeof(detail::CacheHeader));
+            StorageParser<std::string>(out, storage);
+
+            streams::XxHash64 checksum;
+            myakish::Size skip = sizeof(detail::CacheHeader);
+
+            for (auto piece : out.Pieces())
+            {
+                auto size = static_cast<myakish::Size>(piece.size());
+                auto skipped = std::min(skip, size);
+
+                checksum.Update(piece.data() + skipped, size - skipped);
+                skip -= skipped;
+            }
+
+            detail::CacheHeader value{ detail::CacheHeader::ExpectedMagic, detail::CacheHeader::ExpectedVersion, key, out.Offset() - static_cast<myakish::Size>(sizeof(detail::CacheHeader)), checksum.Value() };
+            std::memcpy(header, &value, sizeof(value));
+
+            // Each writer gets a file of its own, so processes storing the same entry never interleave before the rename
+            std::random_device entropy;
+
+            auto temporary = path;
+            temporary += std::format(".{:08x}{:08x}.tmp", entropy(), entropy());
+
+            {
+                streams::NativeFile file(temporary, streams::FileMode::Overwrite);
+                if (!file.Valid()) return;
+
+                if (!out.Flush(file))
+                {
+                    file.Close();
+                    fs::remove(temporary, error);
+                    return;
+                }
+            }
+
+            fs::rename(temporary, path, error);
+            if (error) fs::remove(temporary, error);
+        }
+    };
+}
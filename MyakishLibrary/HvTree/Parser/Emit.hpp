@@ -0,0 +1,354 @@
+#pragma once
+
+#include <MyakishLibrary/HvTree/Parser/Values.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <tuple>
+
+namespace myakish::tree::parse
+{
+    template<streams::OutputStream Underlying>
+    struct TextWriter
+    {
+        inline constexpr static myakish::Size Capacity = 1 << 16;
+
+        Underlying& stream;
+        std::unique_ptr<char[]> buffer;
+        myakish::Size used;
+
+        TextWriter(Underlying& stream) : stream(stream), buffer(std::make_unique_for_overwrite<char[]>(Capacity)), used(0) {}
+
+        TextWriter(const TextWriter&) = delete;
+
+        ~TextWriter()
+        {
+            Flush();
+        }
+
+        char* Acquire(myakish::Size size)
+        {
+            if (used + size > Capacity) Flush();
+            return buffer.get() + used;
+        }
+
+        void Commit(char* end)
+        {
+            used = end - buffer.get();
+        }
+
+        void Put(std::string_view text)
+        {
+            auto size = static_cast<myakish::Size>(text.size());
+
+            if (size > Capacity)
+            {
+                Flush();
+                streams::Write(stream, AsBytePtr(text.data()), size);
+                return;
+            }
+
+            auto at = Acquire(size);
+            std::memcpy(at, text.data(), size);
+            used += size;
+        }
+
+        void Put(char c)
+        {
+            *Acquire(1) = c;
+            used++;
+        }
+
+        void Indent(int level)
+        {
+            constexpr std::string_view Tabs = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+
+            for (; level > 0; level -= static_cast<int>(Tabs.size()))
+                Put(Tabs.substr(0, std::min<std::size_t>(level, Tabs.size())));
+        }
+
+        void Flush()
+        {
+            if (used) streams::Write(stream, AsBytePtr(buffer.get()), std::exchange(used, 0));
+        }
+    };
+
+    template<streams::OutputStream Underlying>
+    TextWriter(Underlying&) -> TextWriter<Underlying>;
+
+
+    template<typename Type>
+    concept FormattableValueParserConcept = ValueParserConcept<Type> && requires(typename Type::Value value, char* out)
+    {
+        { Type::FormatValue(value, out) } -> std::same_as<char*>;
+        { Type::MaxFormattedSize } -> std::convertible_to<myakish::Size>;
+    };
+
+    namespace detail
+    {
+        template<typename Writer>
+        void PutType(Writer& writer, std::string_view type)
+        {
+            writer.Put(": ");
+            writer.Put(type);
+            writer.Put(" >> ");
+        }
+
+        // Data carries no type tag, so a floating formatter only claims bit patterns that read as ordinary numbers.
+        // Those of small integers are subnormal or NaN and never qualify
+        template<typename Type>
+        bool Plausible(Type value)
+        {
+            if constexpr (std::floating_point<Type>)
+            {
+                auto magnitude = std::abs(value);
+                return std::isnormal(value) && magnitude >= std::ldexp(Type(1), -32) && magnitude < std::ldexp(Type(1), 64);
+            }
+            else return true;
+        }
+    }
+
+    template<FormattableValueParserConcept Parser>
+    struct ValueFormatter
+    {
+        using Value = typename Parser::Value;
+
+        constexpr ValueFormatter(const Parser&) {}
+
+        template<typename Writer>
+        bool operator()(Writer& writer, std::span<const std::byte> data) const
+        {
+            if (data.size() != sizeof(Value)) return false;
+
+            if constexpr (std::same_as<Value, bool>)
+            {
+                if (std::to_integer<unsigned char>(data[0]) > 1) return false;
+            }
+
+            Value value;
+            std::memcpy(&value, data.data(), sizeof(Value));
+
+            if (!detail::Plausible(value)) return false;
+
+            detail::PutType(writer, Parser::TypeName);
+            writer.Commit(Parser::FormatValue(value, writer.Acquire(Parser::MaxFormattedSize)));
+            return true;
+        }
+    };
+
+    template<FormattableValueParserConcept Element>
+    struct ArrayFormatter
+    {
+        using Value = typename Element::Value;
+
+        constexpr ArrayFormatter(const ArrayParserType<Element>&) {}
+
+        template<typename Writer>
+        bool operator()(Writer& writer, std::span<const std::byte> data) const
+        {
+            if (data.size() < sizeof(myakish::Size)) return false;
+
+            myakish::Size count;
+            std::memcpy(&count, data.data(), sizeof(count));
+
+            auto elements = data.subspan(sizeof(count));
+            if (count < 0 || elements.size() != static_cast<std::size_t>(count) * sizeof(Value)) return false;
+
+            for (myakish::Size i = 0; i < count; i++)
+            {
+                Value value;
+                std::memcpy(&value, elements.data() + i * sizeof(Value), sizeof(Value));
+
+                if (value != Value{} && !detail::Plausible(value)) return false;
+            }
+
+            detail::PutType(writer, ArrayParserType<Element>::TypeName);
+            writer.Put('[');
+
+            for (myakish::Size i = 0; i < count; i++)
+            {
+                Value value;
+                std::memcpy(&value, elements.data() + i * sizeof(Value), sizeof(Value));
+
+                if (i) writer.Put(", ");
+                writer.Commit(Element::FormatValue(value, writer.Acquire(Element::MaxFormattedSize)));
+            }
+
+            writer.Put(']');
+            return true;
+        }
+    };
+
+    struct BytesFormatter
+    {
+        constexpr BytesFormatter() = default;
+        constexpr BytesFormatter(const BytesParserType&) {}
+
+        template<typename Writer>
+        bool operator()(Writer& writer, std::span<const std::byte> data) const
+        {
+            constexpr std::string_view Digits = "0123456789abcdef";
+            constexpr std::size_t Chunk = 4096;
+
+            detail::PutType(writer, BytesParserType::TypeName);
+
+            while (!data.empty())
+            {
+                auto count = std::min(data.size(), Chunk);
+                auto out = writer.Acquire(static_cast<myakish::Size>(2 * count));
+
+                for (auto byte : data.first(count))
+                {
+                    auto value = std::to_integer<unsigned char>(byte);
+                    *out++ = Digits[value >> 4];
+                    *out++ = Digits[value & 0xF];
+                }
+
+                writer.Commit(out);
+                data = data.subspan(count);
+            }
+            return true;
+        }
+    };
+
+    template<FormattableValueParserConcept Parser>
+    ValueFormatter(const Parser&) -> ValueFormatter<Parser>;
+
+    template<FormattableValueParserConcept Element>
+    ArrayFormatter(const ArrayParserType<Element>&) -> ArrayFormatter<Element>;
+
+
+    template<typename... Formatters>
+    struct FormatterChain
+    {
+        std::tuple<Formatters...> formatters;
+
+        constexpr FormatterChain(Formatters... formatters) : formatters(std::move(formatters)...) {}
+
+        template<typename Writer>
+        bool operator()(Writer& writer, std::span<const std::byte> data) const
+        {
+            auto TryInOrder = [&](const auto&... formatter)
+                {
+                    return (formatter(writer, data) || ...);
+                };
+
+            return std::apply(TryInOrder, formatters);
+        }
+    };
+
+    struct FormatWithFunctor : functional::ExtensionMethod
+    {
+        template<typename... Parsers>
+        constexpr auto operator()(const Parsers&... parsers) const
+        {
+            return FormatterChain(Formatter(parsers)...);
+        }
+
+    private:
+
+        template<FormattableValueParserConcept Parser>
+        constexpr static auto Formatter(const Parser& parser)
+        {
+            return ValueFormatter(parser);
+        }
+
+        template<FormattableValueParserConcept Element>
+        constexpr static auto Formatter(const ArrayParserType<Element>& parser)
+        {
+            return ArrayFormatter(parser);
+        }
+
+        constexpr static auto Formatter(const BytesParserType& parser)
+        {
+            return BytesFormatter(parser);
+        }
+    };
+    inline constexpr FormatWithFunctor FormatWith;
+
+    // Formatters are picked by data size, so each width gets the reading most values of that width are meant to have:
+    // doubles before i64, ints before floats. Unsigned, duration and size values come out as the signed integer
+    // of their width, which still round-trips; pass FormatWith(DurationParser, ...) when the schema is known
+    inline constexpr auto StandardFormatters = FormatWith(
+        BoolParser, I8Parser, I16Parser, IntParser, DoubleParser, I64Parser,
+        ArrayOf(DoubleParser), ArrayOf(I64Parser), ArrayOf(IntParser));
+
+
+    namespace detail
+    {
+        inline bool NeedsQuotes(std::string_view name)
+        {
+            return name.empty() || name.starts_with('"') || name.starts_with('@') ||
+                name.find_first_of(" \t\r\n:") != std::string_view::npos ||
+                name.find(">>") != std::string_view::npos;
+        }
+
+        template<typename Writer>
+        void PutHandle(Writer& writer, std::string_view name)
+        {
+            if (!NeedsQuotes(name))
+            {
+                writer.Put(name);
+                return;
+            }
+
+            writer.Put('"');
+            for (auto c : name)
+            {
+                if (c == '"' || c == '\\') writer.Put('\\');
+                writer.Put(c);
+            }
+            writer.Put('"');
+        }
+
+        template<typename Writer, TreeConcept TreeType, typename Formatter>
+        bool EmitData(Writer& writer, const TreeType& tree, const Formatter& formatter)
+        {
+            auto in = Read(tree);
+            auto data = std::span<const std::byte>(streams::Data(in), static_cast<std::size_t>(streams::Length(in)));
+
+            if (data.empty()) return false;
+
+            if (!formatter(writer, data)) BytesFormatter{}(writer, data);
+            return true;
+        }
+
+        template<typename Writer, TreeConcept TreeType, typename Formatter>
+        void EmitEntry(Writer& writer, const TreeType& tree, int nestingLevel, const Formatter& formatter)
+        {
+            writer.Indent(nestingLevel);
+            PutHandle(writer, Handle(tree));
+            EmitData(writer, tree, formatter);
+
+            writer.Put('\n');
+
+            for (auto&& child : Children(tree)) EmitEntry(writer, child, nestingLevel + 1, formatter);
+        }
+    }
+
+
+    struct EmitFunctor : functional::ExtensionMethod
+    {
+        template<TreeConcept TreeType, typename Formatter> requires streams::PersistentDataStream<decltype(std::declval<const TreeType&>().Read())>
+        void operator()(streams::OutputStream auto&& out, const TreeType& tree, const Formatter& formatter) const
+        {
+            TextWriter writer(out);
+
+            // Root data goes on a nameless first line
+            if (detail::EmitData(writer, tree, formatter)) writer.Put('\n');
+
+            for (auto&& child : Children(tree)) detail::EmitEntry(writer, child, 0, formatter);
+        }
+
+        template<TreeConcept TreeType> requires streams::PersistentDataStream<decltype(std::declval<const TreeType&>().Read())>
+        void operator()(streams::OutputStream auto&& out, const TreeType& tree) const
+        {
+            operator()(out, tree, StandardFormatters);
+        }
+    };
+    inline constexpr EmitFunctor Emit;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <MyakishLibrary/HvTree/Parser/Parser.hpp>
+
+#include <MyakishLibrary/Streams/Async.hpp>
+
+#include <MyakishLibrary/Utility.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace myakish::tree::parse
+{
+    // Files are read and tokenized in parallel on a bounded pool; no task ever waits on another.
+    // Once the whole include graph is known, entries are assembled depth-first on the calling thread,
+    // where a file reached again while it is still being assembled is an include cycle.
+    // Only the top-level file may give the root a value
+    class IncludeLoader
+    {
+    public:
+
+        using SharedTree = std::shared_ptr<const ast::AST>;
+
+        explicit IncludeLoader(streams::IoService& pool = streams::IoService::Default()) : pool(&pool) {}
+
+        SharedTree Load(const fs::path& path)
+        {
+            auto root = fs::weakly_canonical(path);
+
+            Schedule(root);
+
+            {
+                std::unique_lock lock(mutex);
+                done.wait(lock, [&] { return pending == 0; });
+
+                if (error) std::rethrow_exception(std::exchange(error, nullptr));
+            }
+
+            return Resolve(root);
+        }
+
+    private:
+
+        struct File
+        {
+            grammar::File lines;
+            std::map<std::string, fs::path> includes;
+
+            SharedTree tree;
+            bool resolving = false;
+        };
+
+        streams::IoService* pool;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t pending = 0;
+        std::exception_ptr error;
+
+        std::map<fs::path, File> files;
+
+        void Schedule(fs::path path)
+        {
+            {
+                std::scoped_lock lock(mutex);
+
+                if (!files.try_emplace(path).second) return;
+                pending++;
+            }
+
+            pool->Post([this, path = std::move(path)] { Scan(path); });
+        }
+
+        void Scan(const fs::path& path)
+        {
+            try
+            {
+                auto text = ReadTextFile(path);
+                auto lines = grammar::Parse(text).value();
+
+                std::map<std::string, fs::path> includes;
+
+                for (auto&& line : lines)
+                    if (line.include) includes.try_emplace(*line.include, fs::weakly_canonical(path.parent_path() / *line.include));
+
+                for (auto&& [_, include] : includes) Schedule(include);
+
+                std::scoped_lock lock(mutex);
+
+                auto& file = files.at(path);
+                file.lines = std::move(lines);
+                file.includes = std::move(includes);
+            }
+            catch (...)
+            {
+                std::scoped_lock lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+
+            std::scoped_lock lock(mutex);
+            if (--pending == 0) done.notify_all();
+        }
+
+        SharedTree Resolve(const fs::path& path)
+        {
+            auto& file = files.at(path);
+
+            if (file.tree) return file.tree;
+            if (file.resolving) throw std::runtime_error(std::format("include cycle through {}", path.string()));
+
+            file.resolving = true;
+
+            auto Include = [&](const std::string& include) -> const ast::Entries&
+                {
+                    auto& included = *Resolve(file.includes.at(include));
+                    if (included.value) throw std::runtime_error(std::format("root value in @include {}", include));
+
+                    return included.entries;
+                };
+
+            file.tree = std::make_shared<const ast::AST>(ast::ParseTreeIncluding(file.lines, Include));
+            file.resolving = false;
+
+            return file.tree;
+        }
+    };
+
+
+    struct ParseFileFunctor : functional::ExtensionMethod
+    {
+        template<ParserConcept... Parsers>
+        auto operator()(const fs::path& path, const Parsers... parsers) const
+        {
+            IncludeLoader loader;
+            auto tree = loader.Load(path);
+
+            return Build(ASTSource(
+                *tree,
+                functional::RightFold(Chain, parsers...)
+            ));
+        }
+    };
+    inline constexpr ParseFileFunctor ParseFile;
+}
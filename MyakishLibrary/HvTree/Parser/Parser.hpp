@@ -6,10 +6,16 @@
 
 #include <MyakishLibrary/Functional/ExtensionMethod.hpp>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
 #include <map>
+#include <optional>
 #include <ranges>
 #include <set>
 #include <string>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -40,6 +46,99 @@ namespace myakish::tree::parse
 
     inline constexpr auto Chain = functional::DeduceConstruct<ChainParser>;
 
+
+    template<typename Type>
+    concept TypedParserConcept = ParserConcept<Type> && requires
+    {
+        { Type::TypeName } -> std::convertible_to<std::string_view>;
+    };
+
+    namespace detail
+    {
+        struct RegistrySlot
+        {
+            std::uint64_t hash;
+            std::string_view name;
+            std::size_t index;
+        };
+
+        template<TypedParserConcept... Typed>
+        consteval auto MakeRegistryTable()
+        {
+            std::array<RegistrySlot, sizeof...(Typed)> table{};
+
+            std::size_t index = 0;
+            ((table[index] = RegistrySlot{ Hash(std::string_view(Typed::TypeName)), Typed::TypeName, index }, index++), ...);
+
+            std::ranges::sort(table, {}, &RegistrySlot::hash);
+            return table;
+        }
+
+        template<TypedParserConcept... Typed>
+        inline constexpr auto RegistryTable = MakeRegistryTable<Typed...>();
+    }
+
+    template<typename Typed, typename Fallbacks>
+    struct ParserRegistry;
+
+    template<TypedParserConcept... Typed, ParserConcept... Fallbacks>
+    struct ParserRegistry<std::tuple<Typed...>, std::tuple<Fallbacks...>>
+    {
+        std::tuple<Typed...> typed;
+        std::tuple<Fallbacks...> fallbacks;
+
+        constexpr ParserRegistry(std::tuple<Typed...> typed, std::tuple<Fallbacks...> fallbacks) : typed(std::move(typed)), fallbacks(std::move(fallbacks)) {}
+
+        inline constexpr static auto& Table = detail::RegistryTable<Typed...>;
+
+        static_assert(std::ranges::adjacent_find(Table, {}, &detail::RegistrySlot::hash) == std::ranges::end(Table), "ParserRegistry type names must be unique and must not collide");
+
+        bool operator()(streams::OutputStream auto&& out, std::string_view value, std::optional<std::string_view> explicitType) const
+        {
+            using Stream = std::remove_reference_t<decltype(out)>;
+
+            if (explicitType)
+            {
+                auto hash = Hash(*explicitType);
+
+                auto slot = std::ranges::lower_bound(Table, hash, {}, &detail::RegistrySlot::hash);
+                if (slot == std::ranges::end(Table) || slot->hash != hash || slot->name != *explicitType) return false;
+
+                constexpr static auto Dispatchers = MakeDispatchers<Stream>(std::index_sequence_for<Typed...>{});
+
+                return Dispatchers[slot->index](*this, out, value, explicitType);
+            }
+
+            auto TryInOrder = [&](const auto&... fallback)
+                {
+                    return (fallback(out, value, explicitType) || ...);
+                };
+
+            return std::apply(TryInOrder, fallbacks);
+        }
+
+    private:
+
+        template<typename Stream>
+        using Dispatcher = bool(*)(const ParserRegistry&, Stream&, std::string_view, std::optional<std::string_view>);
+
+        template<typename Stream, std::size_t Index>
+        static bool Dispatch(const ParserRegistry& self, Stream& out, std::string_view value, std::optional<std::string_view> explicitType)
+        {
+            return std::get<Index>(self.typed)(out, value, explicitType);
+        }
+
+        template<typename Stream, std::size_t... Indices>
+        consteval static auto MakeDispatchers(std::index_sequence<Indices...>)
+        {
+            return std::array<Dispatcher<Stream>, sizeof...(Typed)>{ &Dispatch<Stream, Indices>... };
+        }
+    };
+    template<typename... Typed, typename... Fallbacks>
+    ParserRegistry(std::tuple<Typed...>, std::tuple<Fallbacks...>) -> ParserRegistry<std::tuple<Typed...>, std::tuple<Fallbacks...>>;
+
+    inline constexpr auto Registry = functional::DeduceConstruct<ParserRegistry>;
+
     template<ParserConcept Parser>
     struct EntriesSource;
 
@@ -88,13 +187,57 @@ namespace myakish::tree::parse
     };
 
 
-    struct IntParserType : functional::ExtensionMethod
+    namespace detail
     {
-        bool operator()(streams::OutputStream auto&& out, std::string_view value, std::optional<std::string_view> type) const
+        constexpr std::string_view Trim(std::string_view view)
         {
-            if (type && *type != "int") return false;
+            constexpr std::string_view Whitespace = " \t\r\n";
 
-            if (auto result = boost::parser::parse(value, boost::parser::int_))
+            auto begin = view.find_first_not_of(Whitespace);
+            if (begin == std::string_view::npos) return {};
+
+            auto end = view.find_last_not_of(Whitespace);
+            return view.substr(begin, end - begin + 1);
+        }
+
+        template<typename Number, typename... Args>
+        std::optional<Number> FromCharsExact(std::string_view view, Args... args)
+        {
+            Number result{};
+
+            auto [ptr, error] = std::from_chars(view.data(), view.data() + view.size(), result, args...);
+            if (error != std::errc{} || ptr != view.data() + view.size()) return std::nullopt;
+
+            return result;
+        }
+
+        template<std::integral Type>
+        inline constexpr std::string_view IntegerTypeName = {};
+
+        template<> inline constexpr std::string_view IntegerTypeName<std::int8_t> = "i8";
+        template<> inline constexpr std::string_view IntegerTypeName<std::int16_t> = "i16";
+        template<> inline constexpr std::string_view IntegerTypeName<std::int32_t> = "int";
+        template<> inline constexpr std::string_view IntegerTypeName<std::int64_t> = "i64";
+        template<> inline constexpr std::string_view IntegerTypeName<std::uint8_t> = "u8";
+        template<> inline constexpr std::string_view IntegerTypeName<std::uint16_t> = "u16";
+        template<> inline constexpr std::string_view IntegerTypeName<std::uint32_t> = "u32";
+        template<> inline constexpr std::string_view IntegerTypeName<std::uint64_t> = "u64";
+    }
+
+    template<typename Type>
+    concept ValueParserConcept = TypedParserConcept<Type> && meta::TriviallyCopyableConcept<typename Type::Value> && requires(std::string_view value)
+    {
+        { Type::ParseValue(value) } -> std::same_as<std::optional<typename Type::Value>>;
+    };
+
+    struct ValueParserBase : functional::ExtensionMethod
+    {
+        template<typename Self>
+        bool operator()(this const Self&, streams::OutputStream auto&& out, std::string_view value, std::optional<std::string_view> type)
+        {
+            if (type && *type != Self::TypeName) return false;
+
+            if (auto result = Self::ParseValue(detail::Trim(value)))
             {
                 out | streams::WriteTrivial[*result];
                 return true;
@@ -102,6 +245,62 @@ namespace myakish::tree::parse
             return false;
         }
     };
+
+
+    template<std::integral Type>
+    struct IntegerParserType : ValueParserBase
+    {
+        using Value = Type;
+
+        inline constexpr static std::string_view TypeName = detail::IntegerTypeName<Type>;
+        static_assert(!TypeName.empty(), "IntegerParserType requires a fixed-width integer type");
+
+        static std::optional<Value> ParseValue(std::string_view value)
+        {
+            using Unsigned = std::make_unsigned_t<Type>;
+
+            bool negative = value.starts_with('-');
+            if (negative || value.starts_with('+')) value.remove_prefix(1);
+
+            int base = 10;
+            if (value.size() > 2 && value[0] == '0')
+            {
+                switch (value[1])
+                {
+                case 'x': case 'X': base = 16; break;
+                case 'b': case 'B': base = 2; break;
+                case 'o': case 'O': base = 8; break;
+                }
+                if (base != 10) value.remove_prefix(2);
+            }
+
+            if (value.empty() || value.front() == '-' || value.front() == '+') return std::nullopt;
+
+            auto magnitude = detail::FromCharsExact<Unsigned>(value, base);
+            if (!magnitude) return std::nullopt;
+
+            if constexpr (std::unsigned_integral<Type>)
+            {
+                if (negative && *magnitude) return std::nullopt;
+                return *magnitude;
+            }
+            else
+            {
+                constexpr auto Limit = static_cast<Unsigned>(std::numeric_limits<Type>::max());
+
+                if (*magnitude > Limit + !!negative) return std::nullopt;
+                return static_cast<Type>(negative ? Unsigned(0) - *magnitude : *magnitude);
+            }
+        }
+
+        inline constexpr static myakish::Size MaxFormattedSize = std::numeric_limits<Type>::digits10 + 3;
+
+        static char* FormatValue(Value value, char* out)
+        {
+            return std::to_chars(out, out + MaxFormattedSize, value).ptr;
+        }
+    };
+    using IntParserType = IntegerParserType<std::int32_t>;
     inline constexpr IntParserType IntParser;
 
 
@@ -110,8 +309,8 @@ namespace myakish::tree::parse
         template<boost::parser::parsable_range Range, ParserConcept... Parsers>
         auto operator()(Range&& range, const Parsers... parsers) const
         {
-            return Build(EntriesSource(
-                ast::Parse(range),
+            return Build(ASTSource(
+                ast::ParseTree(range),
                 functional::RightFold(Chain, parsers...)
             ));
         }
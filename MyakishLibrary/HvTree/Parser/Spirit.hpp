@@ -12,6 +12,7 @@
 #include <vector>
 #include <print>
 #include <format>
+#include <stdexcept>
 
 #include <MyakishLibrary/Meta.hpp>
 
@@ -61,6 +62,8 @@ namespace myakish::tree::parse
             std::string name;
             std::optional<std::string> explicitType = std::nullopt;
             std::optional<std::string> value = std::nullopt;
+            std::optional<std::string> include = std::nullopt;
+            bool root = false;
         };
 
         bp::rule<struct LineParserTag, Line> LineParser = "line";
@@ -90,9 +93,17 @@ namespace myakish::tree::parse
             -TypeParser >>
             -ValueParser;
 
+        // A nameless line carries the data of the tree root itself
+        const auto RootValuesParser = (TypeParser >> -ValueParser | ValueParser) >> bp::eps[SetProjectedTo<&Line::root>(true)];
+
+        // The keyword must end at a word boundary, so entries merely starting with it stay entries
+        const auto IncludeStartParser = bp::lexeme["@include"_l >> &(bp::ws | '"'_l)];
+
+        const auto IncludeParser = IncludeStartParser >> (bp::quoted_string | NonEmptyStringParser(bp::ws))[SetProjected<&Line::include>];
+
         const auto LineParser_def =
             IdentationParser[SetProjected<&Line::nestingLevel>] >>
-            bp::skip(bp::ws - bp::eol)[LineValuesParser] >>
+            bp::skip(bp::ws - bp::eol)[IncludeParser | RootValuesParser | LineValuesParser] >>
             -bp::eol;
 
         BOOST_PARSER_DEFINE_RULES(LineParser, IdentationParser);
@@ -121,11 +132,13 @@ namespace myakish::tree::parse
             Entries entries;
         };
 
-        Entries Parse(auto& begin, const auto& end, int currentNestingLevel = 0)
+        inline constexpr auto IgnoreIncludes = [](const std::string&) { return Entries{}; };
+
+        Entries Parse(auto& begin, const auto& end, int currentNestingLevel, const auto& include)
         {
             Entries result;
 
-            Entries::iterator last{};
+            auto last = result.end();
 
             while (begin != end)
             {
@@ -133,9 +146,22 @@ namespace myakish::tree::parse
 
                 if (line.nestingLevel > currentNestingLevel)
                 {
-                    last->second.entries.insert_range(Parse(begin, end, currentNestingLevel + 1));
+                    if (last == result.end()) throw std::runtime_error("indented entry without a parent");
+
+                    last->second.entries.insert_range(Parse(begin, end, currentNestingLevel + 1, include));
                 }
                 else if (line.nestingLevel < currentNestingLevel) return result;
+                else if (line.root) throw std::runtime_error("root value is only allowed on the first line of the top-level file");
+                else if (line.include)
+                {
+                    for (auto&& [name, ast] : include(*line.include))
+                        if (!result.try_emplace(name, ast).second) throw std::runtime_error(std::format("duplicate entry {} from @include {}", name, *line.include));
+
+                    // An include brings in several entries, none of which can own the following indented lines
+                    last = result.end();
+
+                    begin++;
+                }
                 else
                 {              
                     AST ast{};
@@ -176,15 +202,54 @@ namespace myakish::tree::parse
             }
         }
 
-        Entries Parse(meta::RangeOfConcept<grammar::Line> auto&& range)
+        // A nameless first line gives the root its data; the Entries overloads below accept and drop it
+        AST ParseTreeIncluding(meta::RangeOfConcept<grammar::Line> auto&& range, const auto& include)
         {
             auto begin = std::ranges::begin(range);
-            return Parse(begin, std::ranges::end(range), 0);
+            auto end = std::ranges::end(range);
+
+            AST root{};
+
+            if (begin != end)
+            {
+                grammar::Line line = *begin;
+
+                if (line.root && line.nestingLevel == 0)
+                {
+                    root.value = std::move(line).value;
+                    root.explicitType = std::move(line).explicitType;
+
+                    begin++;
+                }
+            }
+
+            root.entries = Parse(begin, end, 0, include);
+            return root;
+        }
+
+        Entries ParseIncluding(meta::RangeOfConcept<grammar::Line> auto&& range, const auto& include)
+        {
+            return ParseTreeIncluding(range, include).entries;
+        }
+
+        Entries Parse(meta::RangeOfConcept<grammar::Line> auto&& range)
+        {
+            return ParseIncluding(range, IgnoreIncludes);
         }
 
         Entries Parse(boost::parser::parsable_range auto&& range)
         {
             return Parse(grammar::Parse(range).value());
         }
+
+        AST ParseTree(meta::RangeOfConcept<grammar::Line> auto&& range)
+        {
+            return ParseTreeIncluding(range, IgnoreIncludes);
+        }
+
+        AST ParseTree(boost::parser::parsable_range auto&& range)
+        {
+            return ParseTree(grammar::Parse(range).value());
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <MyakishLibrary/HvTree/Parser/Parser.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+namespace myakish::tree::parse
+{
+    namespace detail
+    {
+        constexpr std::string_view SkipPlus(std::string_view view)
+        {
+            if (view.starts_with('+')) view.remove_prefix(1);
+            return view;
+        }
+
+        struct Unit
+        {
+            std::string_view suffix;
+            std::int64_t scale;
+        };
+
+        template<std::size_t Count>
+        std::optional<std::int64_t> ParseWithUnit(std::string_view value, const std::array<Unit, Count>& units, bool unitRequired)
+        {
+            auto number = value.substr(0, value.find_first_not_of("0123456789.+-"));
+            auto suffix = Trim(value.substr(number.size()));
+
+            std::int64_t scale = 1;
+
+            if (auto unit = std::ranges::find(units, suffix, &Unit::suffix); unit != std::ranges::end(units)) scale = unit->scale;
+            else if (!suffix.empty() || unitRequired) return std::nullopt;
+
+            constexpr auto Max = std::numeric_limits<std::int64_t>::max();
+            constexpr auto Min = std::numeric_limits<std::int64_t>::min();
+
+            if (auto integer = FromCharsExact<std::int64_t>(SkipPlus(number)))
+            {
+                if (*integer > Max / scale || *integer < Min / scale) return std::nullopt;
+                return *integer * scale;
+            }
+
+            if (auto real = FromCharsExact<double>(SkipPlus(number)))
+            {
+                auto scaled = *real * static_cast<double>(scale);
+                if (!(scaled < static_cast<double>(Max) && scaled > static_cast<double>(Min))) return std::nullopt;
+                return static_cast<std::int64_t>(scaled);
+            }
+
+            return std::nullopt;
+        }
+
+        constexpr int HexDigit(char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        template<std::floating_point Type>
+        inline constexpr std::string_view FloatingTypeName = {};
+
+        template<> inline constexpr std::string_view FloatingTypeName<float> = "float";
+        template<> inline constexpr std::string_view FloatingTypeName<double> = "double";
+
+        // NUL-terminated so the storage is also usable as a C string; the name itself excludes the terminator
+        template<std::size_t Length>
+        consteval std::array<char, Length + 3> ArrayTypeName(std::string_view element)
+        {
+            std::array<char, Length + 3> result{};
+
+            std::ranges::copy(element, result.begin());
+            result[Length] = '[';
+            result[Length + 1] = ']';
+            result[Length + 2] = '\0';
+
+            return result;
+        }
+    }
+
+
+    inline constexpr IntegerParserType<std::int8_t> I8Parser;
+    inline constexpr IntegerParserType<std::int16_t> I16Parser;
+    inline constexpr IntegerParserType<std::int64_t> I64Parser;
+    inline constexpr IntegerParserType<std::uint8_t> U8Parser;
+    inline constexpr IntegerParserType<std::uint16_t> U16Parser;
+    inline constexpr IntegerParserType<std::uint32_t> U32Parser;
+    inline constexpr IntegerParserType<std::uint64_t> U64Parser;
+
+
+    template<std::floating_point Type>
+    struct FloatingParserType : ValueParserBase
+    {
+        using Value = Type;
+
+        inline constexpr static std::string_view TypeName = detail::FloatingTypeName<Type>;
+        static_assert(!TypeName.empty(), "FloatingParserType requires float or double");
+
+        static std::optional<Value> ParseValue(std::string_view value)
+        {
+            return detail::FromCharsExact<Type>(detail::SkipPlus(value));
+        }
+
+        inline constexpr static myakish::Size MaxFormattedSize = 32;
+
+        static char* FormatValue(Value value, char* out)
+        {
+            return std::to_chars(out, out + MaxFormattedSize, value).ptr;
+        }
+    };
+    inline constexpr FloatingParserType<float> FloatParser;
+    inline constexpr FloatingParserType<double> DoubleParser;
+
+
+    struct BoolParserType : ValueParserBase
+    {
+        using Value = bool;
+
+        inline constexpr static std::string_view TypeName = "bool";
+
+        static std::optional<Value> ParseValue(std::string_view value)
+        {
+            if (value == "true") return true;
+            if (value == "false") return false;
+            return std::nullopt;
+        }
+
+        inline constexpr static myakish::Size MaxFormattedSize = 5;
+
+        static char* FormatValue(Value value, char* out)
+        {
+            std::string_view text = value ? "true" : "false";
+            return std::ranges::copy(text, out).out;
+        }
+    };
+    inline constexpr BoolParserType BoolParser;
+
+
+    struct DurationParserType : ValueParserBase
+    {
+        using Value = std::chrono::nanoseconds;
+
+        inline constexpr static std::string_view TypeName = "duration";
+
+        inline constexpr static std::array<detail::Unit, 7> Units =
+        { {
+            { "ns", 1 },
+            { "us", 1'000 },
+            { "ms", 1'000'000 },
+            { "s", 1'000'000'000 },
+            { "min", 60'000'000'000 },
+            { "h", 3'600'000'000'000 },
+            { "d", 86'400'000'000'000 }
+        } };
+
+        static std::optional<Value> ParseValue(std::string_view value)
+        {
+            return detail::ParseWithUnit(value, Units, true).transform(functional::Construct<Value>);
+        }
+
+        inline constexpr static myakish::Size MaxFormattedSize = 24;
+
+        static char* FormatValue(Value value, char* out)
+        {
+            auto count = value.count();
+            auto unit = std::ranges::find_if(Units | std::views::reverse, [&](const detail::Unit& unit) { return unit.scale == 1 || (count != 0 && count % unit.scale == 0); });
+
+            out = std::to_chars(out, out + MaxFormattedSize, count / unit->scale).ptr;
+            return std::ranges::copy(unit->suffix, out).out;
+        }
+    };
+    inline constexpr DurationParserType DurationParser;
+
+
+    struct ByteSizeParserType : ValueParserBase
+    {
+        using Value = myakish::Size;
+
+        inline constexpr static std::string_view TypeName = "size";
+
+        inline constexpr static std::array<detail::Unit, 9> Units =
+        { {
+            { "B", 1 },
+            { "KB", 1'000 },
+            { "MB", 1'000'000 },
+            { "GB", 1'000'000'000 },
+            { "TB", 1'000'000'000'000 },
+            { "KiB", 1ll << 10 },
+            { "MiB", 1ll << 20 },
+            { "GiB", 1ll << 30 },
+            { "TiB", 1ll << 40 }
+        } };
+
+        static std::optional<Value> ParseValue(std::string_view value)
+        {
+            if (value.starts_with('-')) return std::nullopt;
+            return detail::ParseWithUnit(value, Units, false);
+        }
+
+        inline constexpr static myakish::Size MaxFormattedSize = 24;
+
+        static char* FormatValue(Value value, char* out)
+        {
+            auto unit = std::ranges::find_if(Units | std::views::reverse, [&](const detail::Unit& unit) { return unit.scale == 1 || (value != 0 && value % unit.scale == 0); });
+
+            out = std::to_chars(out, out + MaxFormattedSize, value / unit->scale).ptr;
+            return std::ranges::copy(unit->suffix, out).out;
+        }
+    };
+    inline constexpr ByteSizeParserType ByteSizeParser;
+
+
+    struct BytesParserType : functional::ExtensionMethod
+    {
+        inline constexpr static std::string_view TypeName = "bytes";
+
+        bool operator()(streams::OutputStream auto&& out, std::string_view value, std::optional<std::string_view> type) const
+        {
+            if (type && *type != TypeName) return false;
+
+            value = detail::Trim(value);
+            if (value.size() % 2 || !std::ranges::all_of(value, [](char c) { return detail::HexDigit(c) >= 0; })) return false;
+
+            std::array<std::byte, 4096> chunk;
+
+            while (!value.empty())
+            {
+                auto count = std::min(value.size() / 2, chunk.size());
+
+                for (std::size_t i = 0; i < count; i++)
+                    chunk[i] = static_cast<std::byte>(detail::HexDigit(value[2 * i]) << 4 | detail::HexDigit(value[2 * i + 1]));
+
+                streams::Write(out, chunk.data(), static_cast<myakish::Size>(count));
+                value.remove_prefix(2 * count);
+            }
+            return true;
+        }
+    };
+    inline constexpr BytesParserType BytesParser;
+
+
+    template<ValueParserConcept Element> requires(!std::same_as<typename Element::Value, bool>)
+    struct ArrayParserType : functional::ExtensionMethod
+    {
+        using Value = typename Element::Value;
+
+        inline constexpr static auto TypeNameStorage = detail::ArrayTypeName<Element::TypeName.size()>(Element::TypeName);
+        inline constexpr static std::string_view TypeName{ TypeNameStorage.data(), TypeNameStorage.size() - 1 };
+
+        Element element;
+
+        constexpr ArrayParserType(Element element) : element(std::move(element)) {}
+
+        bool operator()(streams::OutputStream auto&& out, std::string_view value, std::optional<std::string_view> type) const
+        {
+            if (type && *type != TypeName) return false;
+
+            value = detail::Trim(value);
+            if (value.size() < 2 || !value.starts_with('[') || !value.ends_with(']')) return false;
+
+            value = detail::Trim(value.substr(1, value.size() - 2));
+
+            std::vector<Value> elements;
+
+            if (!value.empty())
+            {
+                elements.reserve(std::ranges::count(value, ',') + 1);
+
+                for (auto&& part : value | std::views::split(','))
+                {
+                    auto parsed = Element::ParseValue(detail::Trim(std::string_view(part)));
+                    if (!parsed) return false;
+
+                    elements.push_back(*parsed);
+                }
+            }
+
+            out | streams::WriteAs<myakish::Size>[static_cast<myakish::Size>(elements.size())];
+            streams::Write(out, AsBytePtr(elements.data()), static_cast<myakish::Size>(elements.size() * sizeof(Value)));
+            return true;
+        }
+    };
+
+    inline constexpr auto ArrayOf = functional::DeduceConstruct<ArrayParserType>;
+
+
+    inline constexpr auto StandardValues = Registry(
+        std::tuple(
+            IntParser, I8Parser, I16Parser, I64Parser,
+            U8Parser, U16Parser, U32Parser, U64Parser,
+            FloatParser, DoubleParser, BoolParser,
+            DurationParser, ByteSizeParser, BytesParser,
+            ArrayOf(IntParser), ArrayOf(I64Parser), ArrayOf(U64Parser),
+            ArrayOf(FloatParser), ArrayOf(DoubleParser)),
+        std::tuple(
+            BoolParser, IntParser, I64Parser, DoubleParser,
+            DurationParser, ByteSizeParser,
+            ArrayOf(I64Parser), ArrayOf(DoubleParser)));
+}
@@ -5,6 +5,10 @@
 #include <print>
 #include <random>
 #include <string>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <deque>
 
 #include <MyakishLibrary/Any.hpp>
 
@@ -12,6 +16,19 @@
 #include <MyakishLibrary/Meta.hpp>
 
 #include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/File.hpp>
+#include <MyakishLibrary/Streams/Mapped.hpp>
+#include <MyakishLibrary/Streams/Segmented.hpp>
+#include <MyakishLibrary/Streams/Prefetch.hpp>
+#include <MyakishLibrary/Streams/Pipe.hpp>
+#include <MyakishLibrary/Streams/Checksum.hpp>
+#include <MyakishLibrary/Streams/Compression.hpp>
+#include <MyakishLibrary/Streams/AnyStream.hpp>
+#include <MyakishLibrary/Streams/Endian.hpp>
+#include <MyakishLibrary/Streams/Coalescing.hpp>
+#include <MyakishLibrary/Streams/Limit.hpp>
+#include <MyakishLibrary/Streams/Direct.hpp>
+#include <MyakishLibrary/Streams/Metered.hpp>
 
 #include <MyakishLibrary/Utility.hpp>
 
@@ -20,6 +37,11 @@
 #include <MyakishLibrary/HvTree/HvTree.hpp>
 #include <MyakishLibrary/HvTree/Build.hpp>
 #include <MyakishLibrary/HvTree/Parser/Parser.hpp>
+#include <MyakishLibrary/HvTree/Parser/Values.hpp>
+#include <MyakishLibrary/HvTree/Parser/Cache.hpp>
+#include <MyakishLibrary/HvTree/Parser/Include.hpp>
+#include <MyakishLibrary/HvTree/Parser/Emit.hpp>
+#include <MyakishLibrary/HvTree/Async.hpp>
 
 #include <MyakishLibrary/DependencyGraph/Graph.hpp>
 
@@ -89,7 +111,7 @@ int main()
             out | st2::WriteTrivial[1337];
             st2::WriteTrivial(out, 228);
 
-            auto in = data | st2::ReadFromRange | st2::Polymorphize;
+            auto in = data | st2::ReadFromRange | st2::Erase;
 
             auto i1 = st2::ReadTrivial<int>(in);
             auto i2 = st2::ReadTrivial<int>(in);
@@ -114,6 +136,26 @@ int main()
 
         }
 
+        // streams Range
+        {
+            std::vector<std::uint32_t> values{ 1, 2, 3, 4, 5, 6, 7, 8 };
+            std::deque<std::uint32_t> blocks(values.begin(), values.end());
+
+            auto contiguous = st2::RangeInputStream(values);
+            auto chunked = st2::RangeInputStream(blocks);
+
+            contiguous.Seek(2);
+            chunked.Seek(2);
+
+            auto a = contiguous | st2::ReadTrivial<std::uint64_t>;
+            auto b = chunked | st2::ReadTrivial<std::uint64_t>;
+
+            contiguous.Seek(6);
+            chunked.Seek(6);
+
+            std::println("{} {} {} {}", a == b, contiguous | st2::ReadTrivial<std::uint32_t>, chunked | st2::ReadTrivial<std::uint32_t>, contiguous.Valid());
+        }
+
         // streams File
         {
             auto in = std::views::iota(0) | st2::ReadFromRange;
@@ -124,6 +166,230 @@ int main()
             in | st2::Copy[out, 32];
         }
 
+        // streams Buffer
+        {
+            constexpr int Count = 1 << 20;
+
+            auto Measure = [](auto&& out)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    for (int i = 0; i < Count; i++) out | st2::WriteTrivial[static_cast<std::uint16_t>(i)];
+                    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+                };
+
+            std::vector<std::byte> vector;
+            st2::BufferOutputStream buffer;
+
+            auto vectorTime = Measure(st2::VectorOutputStream(vector));
+            auto bufferTime = Measure(buffer);
+
+            auto released = buffer.Release();
+
+            std::println("vector {} buffer {} ({} bytes)", vectorTime, bufferTime, released.Length());
+        }
+
+        // streams Segmented
+        {
+            st2::SegmentedOutputStream out;
+
+            for (int i = 0; i < 1 << 20; i++) out | st2::WriteTrivial[i];
+
+            auto file = st2::NativeFile("segmented.bin", st2::FileMode::Overwrite);
+            auto flushed = out.Flush(file);
+
+            std::println("{} {} {}", std::ranges::distance(out.Segments()), out.Offset(), flushed);
+        }
+
+        // streams BufferedFile
+        {
+            {
+                auto out = st2::BufferedFileOutputStream("buffered.bin");
+
+                for (int i = 0; i < 1000; i++) out | st2::WriteTrivial[i];
+                out | st2::Align[64];
+            }
+
+            auto in = st2::BufferedFileInputStream("buffered.bin");
+
+            auto first = in | st2::ReadTrivial<int>;
+            in.Seek(998 * sizeof(int));
+            auto last = in | st2::ReadTrivial<int>;
+
+            std::println("{} {} {}", first, last, in.Length());
+
+            auto source = st2::BufferedFileInputStream("buffered.bin");
+            auto copy = st2::BufferedFileOutputStream("buffered_copy.bin");
+
+            source | st2::Copy[copy, source.Length()];
+        }
+
+        // streams Prefetch
+        {
+            auto in = st2::Prefetch(st2::BufferedFileInputStream("buffered.bin", 4096), 1024);
+
+            long long sum = 0;
+            for (int i = 0; i < 1000; i++) sum += in | st2::ReadTrivial<int>;
+
+            std::println("{} {} {} {}", sum, in.Offset(), in.Length(), in.Valid());
+        }
+
+        // streams Pipe
+        {
+            auto [out, in] = st2::Pipe(4096);
+
+            std::jthread producer([out = std::move(out)]() mutable
+                {
+                    for (int i = 0; i < 100000; i++) out | st2::WriteTrivial[i];
+                });
+
+            long long sum = 0;
+            for (int i = 0; i < 100000; i++) sum += in | st2::ReadTrivial<int>;
+
+            producer.join();
+            std::println("{} {} {}", sum, in.Offset(), in.Valid());
+        }
+
+        // streams Checksum
+        {
+            auto out = st2::Checksummed(st2::BufferOutputStream{});
+
+            for (int i = 0; i < 1000; i++) out | st2::WriteTrivial[i];
+            auto crc = out.Checksum();
+
+            auto buffer = out.Base().Release();
+            auto in = st2::Checksummed(st2::ContiguousStream<true>(buffer.Data(), buffer.Length()), st2::XxHash64{});
+
+            in.Seek(buffer.Length());
+
+            std::println("{:08x} {:016x} {}", crc, in.Checksum(), in.Length());
+        }
+
+        // streams Compression
+        {
+            {
+                auto out = st2::Compressed(st2::FileOutputStream("compressed.bin"), 1 << 16, &st2::IoService::Default());
+
+                for (int i = 0; i < 1 << 18; i++) out | st2::WriteTrivial[i / 64];
+            }
+
+            auto in = st2::Decompressed(st2::FileInputStream("compressed.bin"));
+
+            in.Seek(1000 * sizeof(int));
+            auto value = in | st2::ReadTrivial<int>;
+
+            std::println("{} {} {} {}", value, in.Offset(), fs::file_size("compressed.bin"), in.Valid());
+        }
+
+        // streams AnyStream
+        {
+            st2::AnyStream out = st2::BufferOutputStream{};
+
+            std::vector<int> values(256, 42);
+            out.WriteMany(std::span<const int>(values));
+
+            std::println("{} {} {}", std::to_underlying(out.Capabilities()), out.Supports(st2::StreamCapability::PersistentData), out.Offset());
+        }
+
+        // streams Coalescing
+        {
+            {
+                auto out = st2::Coalesced(st2::FileOutputStream("coalesced.bin"));
+
+                for (int i = 0; i < 100000; i++)
+                {
+                    out | st2::WriteTrivial[static_cast<std::uint8_t>(i)];
+                    out | st2::WriteTrivial[i];
+                }
+            }
+
+            std::println("{}", fs::file_size("coalesced.bin"));
+        }
+
+        // streams Limit
+        {
+            auto out = st2::BufferOutputStream{};
+
+            out | st2::WriteAs<myakish::Size>[3 * sizeof(int)];
+            for (int i = 0; i < 3; i++) out | st2::WriteTrivial[i];
+            out | st2::WriteTrivial[1337];
+
+            auto buffer = out.Release();
+            auto in = st2::ContiguousStream<true>(buffer.Data(), buffer.Length());
+
+            auto record = in | st2::Limit[in | st2::ReadTrivial<myakish::Size>];
+            auto first = record | st2::ReadTrivial<int>;
+            record | st2::SkipRemaining;
+
+            auto file = st2::FileInputStream("buffered.bin");
+            auto header = file | st2::Limit[16];
+            header | st2::SkipRemaining;
+
+            std::println("{} {} {}", first, in | st2::ReadTrivial<int>, file | st2::ReadTrivial<int>);
+
+            // a length prefix larger than what is left is cut to the parent's end and reported
+            std::byte short_[10]{};
+            auto parent = st2::ContiguousStream<true>(short_, sizeof short_);
+            auto oversized = parent | st2::Limit[1000];
+
+            auto whole = oversized | st2::ReadTrivial<std::uint64_t>;
+            std::println("{} {} {} {}", whole, oversized.Length(), oversized.Valid(), parent.Length());
+        }
+
+        // streams Mapped
+        {
+            {
+                auto out = st2::MappedOutputStream("mapped.bin");
+
+                for (int i = 0; i < 1 << 18; i++) out | st2::WriteTrivial[i];
+                std::memset(out.Write(16), 0xFF, 16);
+            }
+
+            auto in = st2::MappedInputStream("buffered.bin", st2::AccessHint::Random);
+
+            in.Seek(500 * sizeof(int));
+            auto middle = in | st2::ReadTrivial<int>;
+
+            std::println("{} {} {}", middle, in.Offset(), in.Length());
+        }
+
+        // streams Metered
+        {
+            auto sink = st2::AggregatingSink{};
+
+            std::vector<std::byte> data;
+            {
+                auto out = st2::VectorOutputStream(data) | st2::TimedMetered[sink];
+
+                for (int i = 0; i < 1000; i++) out | st2::WriteTrivial[i];
+                out | st2::WriteTrivial["metered"sv];
+            }
+
+            auto writes = sink.Snapshot()[st2::StreamOperation::Write];
+
+            std::println("{} {} {}", writes.calls, writes.bytes, writes.sizes[3]);
+        }
+
+        // streams Direct
+        {
+            {
+                auto out = st2::DirectFileOutputStream("direct.bin");
+
+                out | st2::WriteTrivial[1 << 18];
+                out | st2::Align[out.BlockSize()];
+
+                for (int i = 0; i < 1 << 18; i++) out | st2::WriteTrivial[i];
+            }
+
+            auto in = st2::DirectFileInputStream("direct.bin");
+
+            auto count = in | st2::ReadTrivial<int>;
+            in | st2::Align[in.BlockSize()];
+
+            in.Seek((count - 1) * sizeof(int));
+
+            std::println("{} {} {}", in | st2::ReadTrivial<int>, fs::file_size("direct.bin"), in.Valid());
+        }
+
     }
 
     //Misc
@@ -284,6 +550,76 @@ int main()
 
             std::println();
         }
+
+        // RepeatParser big-endian
+        {
+            std::vector<std::byte> data(1024);
+
+            auto out = data | st2::WriteToRange | st2::WriteOnly | st2::BigEndian;
+            auto in = data | st2::ReadFromRange | st2::BigEndian;
+
+            std::vector<std::uint32_t> srcVec = { 1, 2, 3, 0xDEADBEEF };
+
+            constexpr auto rule = bss::RepeatParser(bss::Trivial<std::uint32_t>);
+
+            rule(out, srcVec);
+
+            std::vector<std::uint32_t> dstVec;
+
+            rule(in, dstVec);
+
+            std::println("{} {:x} {}", std::to_integer<int>(data[7]), dstVec.back(), srcVec == dstVec);
+        }
+
+        // SequenceParser encoded in place
+        {
+            struct Point
+            {
+                int x;
+                float y;
+                std::uint64_t tag;
+            };
+
+            constexpr auto rule = bss::RepeatParser(bss::Int[&Point::x] >> bss::Trivial<float>[&Point::y] >> bss::U64[&Point::tag]);
+
+            std::vector<Point> srcVec = { { 1, 2.5f, 3 }, { 4, 5.5f, 6 } };
+
+            auto out = st2::BufferOutputStream{};
+            rule(out, srcVec);
+
+            auto in = st2::ContiguousStream<true>(out.Bytes().data(), out.Offset());
+
+            std::vector<Point> dstVec;
+            rule(in, dstVec);
+
+            std::println("{} {} {}", out.Offset(), dstVec.back().y, dstVec.back().tag);
+        }
+
+        // wrappers over a byte-order layer
+        {
+            struct Sample
+            {
+                std::uint32_t id;
+                std::uint16_t flags;
+            };
+
+            constexpr auto rule = bss::RepeatParser(bss::Trivial<std::uint32_t>[&Sample::id] >> bss::Trivial<std::uint16_t>[&Sample::flags]);
+
+            std::vector<Sample> srcVec = { { 1, 2 }, { 0xDEADBEEF, 0xCAFE } };
+            std::vector<std::byte> data(64);
+
+            {
+                auto out = st2::Coalesced(data | st2::WriteToRange | st2::WriteOnly | st2::BigEndian);
+                rule(out, srcVec);
+            }
+
+            auto in = data | st2::ReadFromRange | st2::BigEndian | st2::Erase | st2::Limit[32];
+
+            std::vector<Sample> dstVec;
+            rule(in, dstVec);
+
+            std::println("{} {:x} {:x}", std::to_integer<int>(data[11]), dstVec.back().id, dstVec.back().flags);
+        }
     }
 
     // meta
@@ -610,6 +946,30 @@ int main()
             std::println();
         }
 
+        // async
+        {
+            auto storage = hv::Build("async"_tree * hv::RawData(1) / ("leaf"_tree * hv::RawData(2)));
+
+            st2::SyncWait([&]() -> st2::Task<>
+                {
+                    {
+                        st2::AsyncFileOutputStream out("async.bin");
+                        co_await hv::StoreAsync(out, storage);
+                    }
+
+                    st2::AsyncFileInputStream in("async.bin");
+
+                    auto head = hv::AsyncData(in, 0, 16);
+                    auto tail = hv::AsyncData(in, 16, 16);
+
+                    auto fetched = co_await hv::BuildAsync("fetched"_tree / ("head"_tree * head) / ("tail"_tree * tail), head, tail);
+
+                    auto loaded = co_await hv::LoadAsync<std::string>(in);
+
+                    std::println("{} {}", fetched.entries.size(), loaded.entries.size());
+                }());
+        }
+
         // parsing
         {
             auto file = myakish::ReadTextFile("myakishParserTest.hvr");
@@ -619,10 +979,36 @@ int main()
 
             hv::parse::ast::DebugPrint(entries);
 
+            auto keywordLike = hv::parse::ast::Parse(std::string_view("@includes >> 5\n@include_dir >> 6\n"));
+            std::println("{} {}", keywordLike.at("@includes").value.value(), keywordLike.at("@include_dir").value.value());
+
             auto storage = hv::Build(hv::parse::EntriesSource(entries, hv::parse::IntParser));
             
             auto storage2 = hv::parse::Parse(file, hv::parse::IntParser);
 
+            auto registry = hv::parse::Registry(std::tuple(hv::parse::IntParser), std::tuple(hv::parse::IntParser));
+            auto storage3 = hv::parse::Parse(file, registry);
+
+            auto storage4 = hv::parse::Parse(file, hv::parse::StandardValues);
+
+            auto limits = storage4.Root() | hv::At["limits"];
+            auto weights = hv::Acquire<std::vector<double>>(limits | hv::At["weights"]);
+            auto timeout = hv::Acquire<std::chrono::nanoseconds>(limits | hv::At["timeout"]);
+
+            hv::parse::ParseCache cache("hvcache");
+            auto cold = cache.Parse(file, hv::parse::StandardValues);
+            auto warm = cache.Parse(file, hv::parse::StandardValues);
+
+            auto included = hv::parse::ParseFile("myakishParserTest.hvr", hv::parse::StandardValues);
+            auto retries = hv::Acquire<int>(included.Root() | hv::At["extra"] | hv::At["retries"]);
+
+            {
+                auto out = st2::FileOutputStream("roundtrip.hvr");
+                hv::parse::Emit(out, storage4.Root());
+            }
+            auto roundtrip = hv::parse::Parse(myakish::ReadTextFile("roundtrip.hvr"), hv::parse::StandardValues);
+            auto roundtripEntries = hv::parse::ast::Parse(myakish::ReadTextFile("roundtrip.hvr"));
+
             std::println();
         }
     }
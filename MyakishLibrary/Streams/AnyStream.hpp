@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+#include <MyakishLibrary/Enum/BitwiseOperators.hpp>
+
+namespace myakish::streams
+{
+    enum class StreamCapability : unsigned
+    {
+        None = 0,
+
+        Alignable = 1 << 0,
+        Sized = 1 << 1,
+        Input = 1 << 2,
+        PointerInput = 1 << 3,
+        Output = 1 << 4,
+        PointerOutput = 1 << 5,
+        Reservable = 1 << 6,
+        PersistentData = 1 << 7,
+        Values = 1 << 8
+    };
+
+    // Found through ADL, so the generic enum operators stay limited to StreamCapability
+    inline StreamCapability operator|(StreamCapability lhs, StreamCapability rhs)
+    {
+        return enums::operators::operator|(lhs, rhs);
+    }
+
+    inline StreamCapability operator&(StreamCapability lhs, StreamCapability rhs)
+    {
+        return enums::operators::operator&(lhs, rhs);
+    }
+
+    template<Stream Type>
+    consteval StreamCapability CapabilitiesOf()
+    {
+        using enum StreamCapability;
+
+        auto result = std::to_underlying(None);
+
+        if constexpr (AlignableStream<Type>) result |= std::to_underlying(Alignable);
+        if constexpr (SizedStream<Type>) result |= std::to_underlying(Sized);
+        if constexpr (InputStream<Type>) result |= std::to_underlying(Input);
+        if constexpr (PointerInputStream<Type>) result |= std::to_underlying(PointerInput);
+        if constexpr (OutputStream<Type>) result |= std::to_underlying(Output);
+        if constexpr (PointerOutputStream<Type>) result |= std::to_underlying(PointerOutput);
+        if constexpr (ReservableStream<Type>) result |= std::to_underlying(Reservable);
+        if constexpr (PersistentDataStream<Type>) result |= std::to_underlying(PersistentData);
+        if constexpr (ValueStream<Type>) result |= std::to_underlying(Values);
+
+        return static_cast<StreamCapability>(result);
+    }
+
+    // Owning type-erased stream. Dispatch goes through one table of function pointers per stored type;
+    // operations the stored stream lacks leave the AnyStream invalid instead of terminating.
+    // Pointer reads and writes, and Data over sized input, fall back to a staging buffer, so generic code that
+    // picks those paths at compile time works on any stored stream. A staged write reaches the stream before the next operation
+    class AnyStream
+    {
+    public:
+
+        inline constexpr static std::size_t InlineSize = 64;
+
+        AnyStream() : object(nullptr), table(nullptr), valid(false) {}
+
+        template<Stream Type> requires (!std::same_as<std::remove_cvref_t<Type>, AnyStream> && std::constructible_from<std::remove_cvref_t<Type>, Type&&>)
+        AnyStream(Type&& stream) : table(&Model<std::remove_cvref_t<Type>>::Table), valid(true)
+        {
+            using Stored = std::remove_cvref_t<Type>;
+
+            if constexpr (Model<Stored>::Inline) object = new (storage) Stored(std::forward<Type>(stream));
+            else object = new Stored(std::forward<Type>(stream));
+        }
+
+        AnyStream(AnyStream&& rhs) noexcept : table(rhs.table), valid(rhs.valid)
+        {
+            Steal(rhs);
+        }
+
+        AnyStream& operator=(AnyStream&& rhs) noexcept
+        {
+            if (this == &rhs) return *this;
+
+            Reset();
+
+            table = rhs.table;
+            valid = rhs.valid;
+            Steal(rhs);
+
+            return *this;
+        }
+
+        AnyStream(const AnyStream&) = delete;
+
+        ~AnyStream()
+        {
+            Reset();
+        }
+
+        StreamCapability Capabilities() const
+        {
+            return table ? table->capabilities : StreamCapability::None;
+        }
+
+        bool Supports(StreamCapability capability) const
+        {
+            return HasCapability(Capabilities(), capability);
+        }
+
+        void Seek(Size size)
+        {
+            Settle();
+
+            auto skipped = std::min(size, Staged());
+            cursor += skipped;
+
+            if (table && size > skipped) table->seek(object, size - skipped);
+        }
+
+        Size Length() const
+        {
+            return Supports(StreamCapability::Sized) ? table->length(object) + Staged() : Fail(Size{});
+        }
+
+        Size Offset() const
+        {
+            return Supports(StreamCapability::Alignable) ? table->offset(object) - Staged() + pending : Fail(Size{});
+        }
+
+        void Read(std::byte* dst, Size size)
+        {
+            Settle();
+
+            auto buffered = std::min(size, Staged());
+            if (buffered) std::memcpy(dst, staging.data() + cursor, buffered);
+            cursor += buffered;
+
+            if (size == buffered) return;
+
+            if (Supports(StreamCapability::Input)) table->read(object, dst + buffered, size - buffered);
+            else valid = false;
+        }
+
+        const std::byte* Read(Size size)
+        {
+            Settle();
+
+            if (Supports(StreamCapability::PointerInput) && Staged() == 0) return table->readPointer(object, size);
+
+            Stage(size);
+            return staging.data() + std::exchange(cursor, cursor + size);
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            Settle();
+
+            if (Supports(StreamCapability::Output)) table->write(object, src, size);
+            else valid = false;
+        }
+
+        std::byte* Write(Size size)
+        {
+            Settle();
+
+            if (Supports(StreamCapability::PointerOutput)) return table->writePointer(object, size);
+
+            if (static_cast<Size>(staging.size()) < size) staging.resize(size);
+
+            if (Supports(StreamCapability::Output)) pending = size;
+            else valid = false;
+
+            return staging.data();
+        }
+
+        void Reserve(Size size)
+        {
+            Settle();
+
+            if (Supports(StreamCapability::Reservable)) table->reserve(object, size);
+        }
+
+        // Without PersistentData the rest of a sized input stream is staged, and later reads are served from it
+        std::byte* Data()
+        {
+            Settle();
+
+            if (Supports(StreamCapability::PersistentData) && Staged() == 0) return table->data(object);
+            if (!Supports(StreamCapability::Input | StreamCapability::Sized)) return Fail<std::byte*>(nullptr);
+
+            Stage(Length());
+            return staging.data() + cursor;
+        }
+
+        // One indirect call for the whole batch
+        void ReadMany(std::span<const std::span<std::byte>> destinations)
+        {
+            Settle();
+
+            if (Staged() > 0)
+            {
+                for (auto destination : destinations) Read(destination.data(), static_cast<Size>(destination.size()));
+                return;
+            }
+
+            if (Supports(StreamCapability::Input)) table->readMany(object, destinations);
+            else valid = false;
+        }
+
+        void WriteMany(std::span<const std::span<const std::byte>> sources)
+        {
+            Settle();
+
+            if (Supports(StreamCapability::Output)) table->writeMany(object, sources);
+            else valid = false;
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        void ReadMany(std::span<Type> values)
+        {
+            Read(reinterpret_cast<std::byte*>(values.data()), static_cast<Size>(values.size_bytes()));
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        void WriteMany(std::span<const Type> values)
+        {
+            Write(reinterpret_cast<const std::byte*>(values.data()), static_cast<Size>(values.size_bytes()));
+        }
+
+        // A value layer in the stored stream is reached by width, which is all byte order needs;
+        // other types, and stored streams without such a layer, see plain bytes
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        void ReadArray(Type* values, Size count)
+        {
+            Settle();
+
+            if constexpr (ErasedByWidth<Type>)
+            {
+                if (Supports(StreamCapability::Values | StreamCapability::Input) && Staged() == 0)
+                {
+                    table->readValues(object, reinterpret_cast<std::byte*>(values), count, sizeof(Type));
+                    return;
+                }
+            }
+
+            Read(reinterpret_cast<std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        void WriteArray(const Type* values, Size count)
+        {
+            Settle();
+
+            if constexpr (ErasedByWidth<Type>)
+            {
+                if (Supports(StreamCapability::Values | StreamCapability::Output))
+                {
+                    table->writeValues(object, reinterpret_cast<const std::byte*>(values), count, sizeof(Type));
+                    return;
+                }
+            }
+
+            Write(reinterpret_cast<const std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        Type ReadValue()
+        {
+            Type value;
+            ReadArray(&value, 1);
+            return value;
+        }
+
+        template<typename Type> requires std::is_trivially_copyable_v<Type>
+        void WriteValue(Type value)
+        {
+            WriteArray(&value, 1);
+        }
+
+        bool Valid() const
+        {
+            return valid && table && table->valid(object);
+        }
+
+        template<typename Type>
+        Type* Get()
+        {
+            return table == &Model<Type>::Table ? std::launder(static_cast<Type*>(object)) : nullptr;
+        }
+
+    private:
+
+        struct VTable
+        {
+            StreamCapability capabilities;
+
+            void (*destroy)(void*);
+            void (*relocate)(void*, void*);
+
+            void (*seek)(void*, Size);
+            Size(*length)(const void*);
+            Size(*offset)(const void*);
+            void (*read)(void*, std::byte*, Size);
+            const std::byte* (*readPointer)(void*, Size);
+            void (*write)(void*, const std::byte*, Size);
+            std::byte* (*writePointer)(void*, Size);
+            void (*reserve)(void*, Size);
+            std::byte* (*data)(const void*);
+            void (*readMany)(void*, std::span<const std::span<std::byte>>);
+            void (*writeMany)(void*, std::span<const std::span<const std::byte>>);
+            void (*readValues)(void*, std::byte*, Size, Size);
+            void (*writeValues)(void*, const std::byte*, Size, Size);
+            bool (*valid)(const void*);
+        };
+
+        template<typename Type>
+        inline constexpr static bool ErasedByWidth = (std::is_arithmetic_v<Type> || std::is_enum_v<Type>) && (sizeof(Type) == 1 || sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8);
+
+        template<typename Function>
+        static void ByWidth(Size width, Function&& function)
+        {
+            switch (width)
+            {
+            case 1: function.template operator()<std::uint8_t>(); break;
+            case 2: function.template operator()<std::uint16_t>(); break;
+            case 4: function.template operator()<std::uint32_t>(); break;
+            case 8: function.template operator()<std::uint64_t>(); break;
+            }
+        }
+
+        template<typename Type>
+        struct Model
+        {
+            inline constexpr static bool Inline = sizeof(Type) <= InlineSize && alignof(Type) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Type>;
+
+            static Type& Self(void* object)
+            {
+                return *std::launder(static_cast<Type*>(object));
+            }
+
+            static const Type& Self(const void* object)
+            {
+                return *std::launder(static_cast<const Type*>(object));
+            }
+
+            inline constexpr static VTable Table = []
+                {
+                    VTable table{};
+
+                    table.capabilities = CapabilitiesOf<Type>();
+
+                    table.destroy = [](void* object)
+                        {
+                            if constexpr (Inline) Self(object).~Type();
+                            else delete &Self(object);
+                        };
+                    table.relocate = [](void* to, void* from)
+                        {
+                            if constexpr (Inline)
+                            {
+                                new (to) Type(std::move(Self(from)));
+                                Self(from).~Type();
+                            }
+                        };
+
+                    table.seek = [](void* object, Size size) { streams::Seek(Self(object), size); };
+                    table.valid = [](const void* object)
+                        {
+                            if constexpr (requires(const Type& stream) { stream.Valid(); }) return static_cast<bool>(Self(object).Valid());
+                            else return true;
+                        };
+
+                    if constexpr (SizedStream<Type>) table.length = [](const void* object) { return streams::Length(Self(object)); };
+                    if constexpr (AlignableStream<Type>) table.offset = [](const void* object) { return streams::Offset(Self(object)); };
+
+                    if constexpr (InputStream<Type>)
+                    {
+                        table.read = [](void* object, std::byte* dst, Size size) { streams::Read(Self(object), dst, size); };
+                        table.readMany = [](void* object, std::span<const std::span<std::byte>> destinations)
+                            {
+                                for (auto destination : destinations) streams::Read(Self(object), destination.data(), static_cast<Size>(destination.size()));
+                            };
+                    }
+                    if constexpr (PointerInputStream<Type>) table.readPointer = [](void* object, Size size) -> const std::byte* { return streams::Read(Self(object), size); };
+
+                    if constexpr (OutputStream<Type>)
+                    {
+                        table.write = [](void* object, const std::byte* src, Size size) { streams::Write(Self(object), src, size); };
+                        table.writeMany = [](void* object, std::span<const std::span<const std::byte>> sources)
+                            {
+                                for (auto source : sources) streams::Write(Self(object), source.data(), static_cast<Size>(source.size()));
+                            };
+                    }
+                    if constexpr (ValueStream<Type> && InputStream<Type>)
+                        table.readValues = [](void* object, std::byte* dst, Size count, Size width)
+                            {
+                                ByWidth(width, [&]<typename Word>() { streams::ReadArray(Self(object), reinterpret_cast<Word*>(dst), count); });
+                            };
+                    if constexpr (ValueStream<Type> && OutputStream<Type>)
+                        table.writeValues = [](void* object, const std::byte* src, Size count, Size width)
+                            {
+                                ByWidth(width, [&]<typename Word>() { streams::WriteArray(Self(object), reinterpret_cast<const Word*>(src), count); });
+                            };
+
+                    if constexpr (PointerOutputStream<Type>) table.writePointer = [](void* object, Size size) -> std::byte* { return streams::Write(Self(object), size); };
+
+                    if constexpr (ReservableStream<Type>) table.reserve = [](void* object, Size size) { streams::Reserve(Self(object), size); };
+                    if constexpr (PersistentDataStream<Type>)
+                        table.data = [](const void* object) { return const_cast<std::byte*>(streams::Data(const_cast<Type&>(Self(object)))); };
+
+                    return table;
+                }();
+        };
+
+        alignas(std::max_align_t) std::byte storage[InlineSize];
+        void* object;
+        const VTable* table;
+        mutable bool valid;
+
+        // Input: bytes [cursor, staged) were read ahead of the caller. Output: the first `pending` bytes await writing
+        std::vector<std::byte> staging;
+        Size cursor = 0;
+        Size staged = 0;
+        Size pending = 0;
+
+        static bool HasCapability(StreamCapability capabilities, StreamCapability capability)
+        {
+            return (capabilities & capability) == capability;
+        }
+
+        bool IsInline() const
+        {
+            return object == static_cast<const void*>(storage);
+        }
+
+        template<typename Result>
+        Result Fail(Result result) const
+        {
+            valid = false;
+            return result;
+        }
+
+        Size Staged() const
+        {
+            return staged - cursor;
+        }
+
+        // Tops the read-ahead up to `size` bytes; missing input is zero-filled and invalidates the stream
+        void Stage(Size size)
+        {
+            auto available = Staged();
+            if (available >= size) return;
+
+            if (available) std::memmove(staging.data(), staging.data() + cursor, available);
+
+            if (static_cast<Size>(staging.size()) < size) staging.resize(size);
+            cursor = 0;
+            staged = size;
+
+            if (Supports(StreamCapability::Input)) table->read(object, staging.data() + available, size - available);
+            else
+            {
+                std::memset(staging.data() + available, 0, size - available);
+                valid = false;
+            }
+        }
+
+        void Settle()
+        {
+            if (!pending) return;
+
+            table->write(object, staging.data(), std::exchange(pending, 0));
+        }
+
+        void Steal(AnyStream& rhs)
+        {
+            rhs.Settle();
+
+            staging = std::move(rhs.staging);
+            cursor = std::exchange(rhs.cursor, 0);
+            staged = std::exchange(rhs.staged, 0);
+
+            if (!rhs.object) object = nullptr;
+            else if (rhs.IsInline())
+            {
+                object = storage;
+                table->relocate(object, rhs.object);
+            }
+            else object = rhs.object;
+
+            rhs.object = nullptr;
+            rhs.table = nullptr;
+        }
+
+        void Reset()
+        {
+            Settle();
+
+            if (object) table->destroy(object);
+
+            object = nullptr;
+            table = nullptr;
+        }
+    };
+    static_assert(AlignableStream<AnyStream>, "AnyStream must be AlignableStream");
+    static_assert(SizedStream<AnyStream>, "AnyStream must be SizedStream");
+    static_assert(PointerInputStream<AnyStream>, "AnyStream must be PointerInputStream");
+    static_assert(PointerOutputStream<AnyStream>, "AnyStream must be PointerOutputStream");
+    static_assert(ReservableStream<AnyStream>, "AnyStream must be ReservableStream");
+    static_assert(PersistentDataStream<AnyStream>, "AnyStream must be PersistentDataStream");
+
+    struct EraseFunctor : functional::ExtensionMethod
+    {
+        template<Stream Type>
+        AnyStream operator()(Type&& stream) const
+        {
+            return AnyStream(std::forward<Type>(stream));
+        }
+    };
+    inline constexpr EraseFunctor Erase;
+}
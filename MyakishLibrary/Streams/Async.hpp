@@ -0,0 +1,654 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Native.hpp>
+
+#if defined(MYAKISH_IO_URING) && __has_include(<liburing.h>)
+#include <liburing.h>
+#define MYAKISH_USE_IO_URING
+#endif
+
+namespace myakish::streams
+{
+    namespace detail
+    {
+        struct TaskPromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+                {
+                    if (auto continuation = handle.promise().continuation) return continuation;
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception()
+            {
+                exception = std::current_exception();
+            }
+
+            void Rethrow() const
+            {
+                if (exception) std::rethrow_exception(exception);
+            }
+        };
+
+        template<typename Type>
+        struct TaskPromise : TaskPromiseBase
+        {
+            std::optional<Type> value;
+
+            template<std::convertible_to<Type> Value>
+            void return_value(Value&& result)
+            {
+                value.emplace(std::forward<Value>(result));
+            }
+
+            Type Result()
+            {
+                Rethrow();
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct TaskPromise<void> : TaskPromiseBase
+        {
+            void return_void() {}
+
+            void Result()
+            {
+                Rethrow();
+            }
+        };
+
+        struct Detached
+        {
+            struct promise_type
+            {
+                Detached get_return_object() { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+
+                void unhandled_exception()
+                {
+                    std::terminate();
+                }
+            };
+        };
+    }
+
+    template<typename Type = void>
+    class Task
+    {
+    public:
+
+        struct promise_type : detail::TaskPromise<Type>
+        {
+            Task get_return_object()
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        explicit Task(handle_type handle) : handle(handle) {}
+
+        Task(Task&& rhs) noexcept : handle(std::exchange(rhs.handle, nullptr)) {}
+        Task(const Task&) = delete;
+
+        Task& operator=(Task&& rhs) noexcept
+        {
+            std::swap(handle, rhs.handle);
+            return *this;
+        }
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            if (handle) handle.destroy();
+        }
+
+        bool await_ready() const noexcept
+        {
+            return !handle || handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        Type await_resume()
+        {
+            return handle.promise().Result();
+        }
+
+    private:
+
+        handle_type handle;
+    };
+
+    template<typename Type>
+    concept Awaitable = requires(Type awaitable, std::coroutine_handle<> handle)
+    {
+        awaitable.await_ready();
+        awaitable.await_suspend(handle);
+        awaitable.await_resume();
+    };
+
+
+    struct SyncWaitFunctor : functional::ExtensionMethod
+    {
+        template<typename Type>
+        Type operator()(Task<Type> task) const
+        {
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool done = false;
+
+            std::optional<std::conditional_t<std::is_void_v<Type>, std::monostate, Type>> result;
+            std::exception_ptr exception;
+
+            [](Task<Type>& task, auto& result, std::exception_ptr& exception, std::mutex& mutex, std::condition_variable& condition, bool& done) -> detail::Detached
+                {
+                    try
+                    {
+                        if constexpr (std::is_void_v<Type>)
+                        {
+                            co_await task;
+                            result.emplace();
+                        }
+                        else result.emplace(co_await task);
+                    }
+                    catch (...)
+                    {
+                        exception = std::current_exception();
+                    }
+
+                    std::scoped_lock lock(mutex);
+                    done = true;
+                    condition.notify_one();
+                }(task, result, exception, mutex, condition, done);
+
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&] { return done; });
+
+            if (exception) std::rethrow_exception(exception);
+            if constexpr (!std::is_void_v<Type>) return std::move(*result);
+        }
+    };
+    inline constexpr SyncWaitFunctor SyncWait;
+
+    namespace detail
+    {
+        struct WhenAllAwaiter
+        {
+            std::vector<Task<>>& tasks;
+            std::atomic<std::size_t> remaining;
+            std::coroutine_handle<> continuation;
+            std::mutex mutex;
+            std::exception_ptr exception;
+
+            WhenAllAwaiter(std::vector<Task<>>& tasks) : tasks(tasks), remaining(tasks.size() + 1) {}
+
+            bool await_ready() const noexcept
+            {
+                return tasks.empty();
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting)
+            {
+                continuation = awaiting;
+
+                for (auto& task : tasks) Drive(task);
+
+                return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const
+            {
+                if (exception) std::rethrow_exception(exception);
+            }
+
+        private:
+
+            Detached Drive(Task<>& task)
+            {
+                try
+                {
+                    co_await task;
+                }
+                catch (...)
+                {
+                    std::scoped_lock lock(mutex);
+                    if (!exception) exception = std::current_exception();
+                }
+
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) continuation.resume();
+            }
+        };
+    }
+
+    struct WhenAllFunctor : functional::ExtensionMethod
+    {
+        Task<> operator()(std::vector<Task<>> tasks) const
+        {
+            co_await detail::WhenAllAwaiter(tasks);
+        }
+    };
+    inline constexpr WhenAllFunctor WhenAll;
+
+
+    class IoService
+    {
+    public:
+
+        explicit IoService(unsigned threads = std::max(2u, std::thread::hardware_concurrency()))
+        {
+#ifdef MYAKISH_USE_IO_URING
+            if (io_uring_queue_init(QueueDepth, &ring, 0) == 0)
+            {
+                uring = true;
+                reaper = std::jthread([this] { Reap(); });
+            }
+#endif
+            for (unsigned i = 0; i < threads; i++) workers.emplace_back([this] { Work(); });
+        }
+
+        IoService(const IoService&) = delete;
+
+        ~IoService()
+        {
+            {
+                std::scoped_lock lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            workers.clear();
+
+#ifdef MYAKISH_USE_IO_URING
+            if (uring)
+            {
+                {
+                    std::scoped_lock lock(submitMutex);
+                    auto entry = io_uring_get_sqe(&ring);
+                    io_uring_prep_nop(entry);
+                    io_uring_sqe_set_data(entry, nullptr);
+                    io_uring_submit(&ring);
+                }
+                reaper.join();
+                io_uring_queue_exit(&ring);
+            }
+#endif
+        }
+
+        static IoService& Default()
+        {
+            static IoService service;
+            return service;
+        }
+
+        // A throwing job hands its exception to `failed` on the worker thread; without a handler it must not throw
+        void Post(std::move_only_function<void()> job, std::move_only_function<void(std::exception_ptr)> failed = nullptr)
+        {
+            {
+                std::scoped_lock lock(mutex);
+                jobs.push_back({ std::move(job), std::move(failed) });
+            }
+            condition.notify_one();
+        }
+
+        template<typename Function>
+        auto Run(Function function)
+        {
+            using Result = std::invoke_result_t<Function&>;
+
+            struct Awaiter
+            {
+                IoService& service;
+                Function function;
+                std::optional<std::conditional_t<std::is_void_v<Result>, std::monostate, Result>> result;
+                std::exception_ptr exception;
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> awaiting)
+                {
+                    service.Post([this, awaiting]
+                        {
+                            if constexpr (std::is_void_v<Result>)
+                            {
+                                function();
+                                result.emplace();
+                            }
+                            else result.emplace(function());
+
+                            awaiting.resume();
+                        },
+                        [this, awaiting](std::exception_ptr failure)
+                        {
+                            exception = failure;
+                            awaiting.resume();
+                        });
+                }
+
+                Result await_resume()
+                {
+                    if (exception) std::rethrow_exception(exception);
+                    if constexpr (!std::is_void_v<Result>) return std::move(*result);
+                }
+            };
+
+            return Awaiter{ *this, std::move(function), std::nullopt, nullptr };
+        }
+
+        Task<Size> ReadAt(NativeFile& file, std::byte* dst, Size size, Size offset)
+        {
+#ifdef MYAKISH_USE_IO_URING
+            if (uring) co_return co_await Submit(file, dst, size, offset, false);
+#endif
+            co_return co_await Run([&file, dst, size, offset] { return file.ReadAt(dst, size, offset); });
+        }
+
+        Task<Size> WriteAt(NativeFile& file, const std::byte* src, Size size, Size offset)
+        {
+#ifdef MYAKISH_USE_IO_URING
+            if (uring) co_return co_await Submit(file, const_cast<std::byte*>(src), size, offset, true);
+#endif
+            co_return co_await Run([&file, src, size, offset] { return file.WriteAt(src, size, offset); });
+        }
+
+    private:
+
+        struct Job
+        {
+            std::move_only_function<void()> run;
+            std::move_only_function<void(std::exception_ptr)> failed;
+        };
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Job> jobs;
+        bool stopping = false;
+        std::vector<std::jthread> workers;
+
+        void Work()
+        {
+            while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock lock(mutex);
+                    condition.wait(lock, [&] { return stopping || !jobs.empty(); });
+
+                    if (jobs.empty()) return;
+
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+
+                try
+                {
+                    job.run();
+                }
+                catch (...)
+                {
+                    if (!job.failed) throw;
+                    job.failed(std::current_exception());
+                }
+            }
+        }
+
+#ifdef MYAKISH_USE_IO_URING
+        inline constexpr static unsigned QueueDepth = 256;
+
+        io_uring ring{};
+        bool uring = false;
+        std::mutex submitMutex;
+        std::jthread reaper;
+
+        struct Operation
+        {
+            std::coroutine_handle<> continuation;
+            int result;
+        };
+
+        // io_uring transfers may be short, so loop until done or the kernel reports end/error
+        Task<Size> Submit(NativeFile& file, std::byte* data, Size size, Size offset, bool write)
+        {
+            Size total = 0;
+            while (total < size)
+            {
+                struct Awaiter
+                {
+                    IoService& service;
+                    Operation operation;
+                    int fd;
+                    std::byte* data;
+                    unsigned count;
+                    Size offset;
+                    bool write;
+
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+
+                    void await_suspend(std::coroutine_handle<> awaiting)
+                    {
+                        operation.continuation = awaiting;
+
+                        std::scoped_lock lock(service.submitMutex);
+
+                        auto entry = io_uring_get_sqe(&service.ring);
+                        while (!entry)
+                        {
+                            io_uring_submit(&service.ring);
+                            entry = io_uring_get_sqe(&service.ring);
+                        }
+
+                        if (write) io_uring_prep_write(entry, fd, data, count, offset);
+                        else io_uring_prep_read(entry, fd, data, count, offset);
+
+                        io_uring_sqe_set_data(entry, &operation);
+                        io_uring_submit(&service.ring);
+                    }
+
+                    int await_resume() const noexcept
+                    {
+                        return operation.result;
+                    }
+                };
+
+                auto count = static_cast<unsigned>(std::min<Size>(size - total, Size(1) << 30));
+                auto done = co_await Awaiter{ *this, {}, file.NativeHandle(), data + total, count, offset + total, write };
+
+                if (done <= 0) break;
+                total += done;
+            }
+            co_return total;
+        }
+
+        void Reap()
+        {
+            while (true)
+            {
+                io_uring_cqe* completion = nullptr;
+                if (io_uring_wait_cqe(&ring, &completion) < 0) continue;
+
+                auto operation = static_cast<Operation*>(io_uring_cqe_get_data(completion));
+                auto result = completion->res;
+                io_uring_cqe_seen(&ring, completion);
+
+                if (!operation) return;
+
+                operation->result = result;
+                operation->continuation.resume();
+            }
+        }
+#endif
+    };
+
+
+    template<typename Type>
+    concept AsyncInputStream = Stream<Type> && requires(Type&& in, std::byte* data, Size size)
+    {
+        { in.ReadAsync(data, size) } -> Awaitable;
+    };
+
+    template<typename Type>
+    concept AsyncOutputStream = Stream<Type> && requires(Type&& out, const std::byte* data, Size size)
+    {
+        { out.WriteAsync(data, size) } -> Awaitable;
+    };
+
+    // offsets are claimed when a transfer is created, so several transfers on one stream may be in flight at once
+    struct AsyncFileInputStream
+    {
+        IoService* service;
+        NativeFile file;
+        Size offset;
+        Size length;
+        std::atomic<bool> valid;
+
+        AsyncFileInputStream(const fs::path& path, IoService& service = IoService::Default()) :
+            service(&service), file(path, FileMode::ReadOnly), offset(0), length(file.Length()), valid(file.Valid()) {}
+
+        AsyncFileInputStream(AsyncFileInputStream&& rhs) noexcept :
+            service(rhs.service), file(std::move(rhs.file)), offset(rhs.offset), length(rhs.length), valid(rhs.valid.load()) {}
+        AsyncFileInputStream(const AsyncFileInputStream&) = delete;
+
+        Task<> ReadAsync(std::byte* dst, Size size)
+        {
+            return ReadAtAsync(dst, size, std::exchange(offset, offset + size));
+        }
+
+        Task<> ReadAtAsync(std::byte* dst, Size size, Size at)
+        {
+            auto read = co_await service->ReadAt(file, dst, size, at);
+
+            if (read != size) valid.store(false);
+        }
+
+        void Seek(Size size)
+        {
+            offset += size;
+        }
+
+        Size Offset() const
+        {
+            return offset;
+        }
+
+        Size Length() const
+        {
+            return length - offset;
+        }
+
+        bool Valid() const
+        {
+            return valid.load() && offset <= length;
+        }
+    };
+    static_assert(AsyncInputStream<AsyncFileInputStream>, "AsyncFileInputStream must be AsyncInputStream");
+    static_assert(SizedStream<AsyncFileInputStream>, "AsyncFileInputStream must be SizedStream");
+    static_assert(AlignableStream<AsyncFileInputStream>, "AsyncFileInputStream must be AlignableStream");
+
+    struct AsyncFileOutputStream
+    {
+        IoService* service;
+        NativeFile file;
+        Size offset;
+        Size end;
+        std::atomic<bool> valid;
+
+        AsyncFileOutputStream(const fs::path& path, IoService& service = IoService::Default()) :
+            service(&service), file(path, FileMode::Overwrite), offset(0), end(0), valid(file.Valid()) {}
+
+        AsyncFileOutputStream(AsyncFileOutputStream&& rhs) noexcept :
+            service(rhs.service), file(std::move(rhs.file)), offset(rhs.offset), end(rhs.end), valid(rhs.valid.load()) {}
+        AsyncFileOutputStream(const AsyncFileOutputStream&) = delete;
+
+        ~AsyncFileOutputStream()
+        {
+            Close();
+        }
+
+        Task<> WriteAsync(const std::byte* src, Size size)
+        {
+            auto at = std::exchange(offset, offset + size);
+            end = std::max(end, offset);
+
+            return WriteAtAsync(src, size, at);
+        }
+
+        Task<> WriteAtAsync(const std::byte* src, Size size, Size at)
+        {
+            auto written = co_await service->WriteAt(file, src, size, at);
+
+            if (written != size) valid.store(false);
+        }
+
+        void Seek(Size size)
+        {
+            offset += size;
+            end = std::max(end, offset);
+        }
+
+        Size Offset() const
+        {
+            return offset;
+        }
+
+        void Close()
+        {
+            if (!file.Valid()) return;
+
+            if (file.Length() < end && !file.Truncate(end)) valid.store(false);
+            file.Close();
+        }
+
+        bool Valid() const
+        {
+            return valid.load();
+        }
+    };
+    static_assert(AsyncOutputStream<AsyncFileOutputStream>, "AsyncFileOutputStream must be AsyncOutputStream");
+    static_assert(AlignableStream<AsyncFileOutputStream>, "AsyncFileOutputStream must be AlignableStream");
+}
@@ -0,0 +1,417 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MYAKISH_CRC32C_SSE42
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace myakish::streams
+{
+    namespace detail
+    {
+        inline constexpr auto Crc32cTables = []
+            {
+                std::array<std::array<std::uint32_t, 256>, 8> tables{};
+
+                for (std::uint32_t i = 0; i < 256; i++)
+                {
+                    auto crc = i;
+                    for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+
+                    tables[0][i] = crc;
+                }
+
+                for (std::size_t i = 0; i < 256; i++)
+                    for (std::size_t slice = 1; slice < 8; slice++)
+                        tables[slice][i] = (tables[slice - 1][i] >> 8) ^ tables[0][tables[slice - 1][i] & 0xFF];
+
+                return tables;
+            }();
+
+        // Slicing-by-8
+        inline std::uint32_t Crc32cSoftware(std::uint32_t crc, const std::byte* data, Size size)
+        {
+            const auto& tables = Crc32cTables;
+
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                for (; size >= 8; data += 8, size -= 8)
+                {
+                    std::uint64_t word;
+                    std::memcpy(&word, data, 8);
+                    word ^= crc;
+
+                    crc = tables[7][word & 0xFF] ^ tables[6][(word >> 8) & 0xFF] ^ tables[5][(word >> 16) & 0xFF] ^ tables[4][(word >> 24) & 0xFF] ^
+                        tables[3][(word >> 32) & 0xFF] ^ tables[2][(word >> 40) & 0xFF] ^ tables[1][(word >> 48) & 0xFF] ^ tables[0][word >> 56];
+                }
+            }
+
+            for (; size > 0; data++, size--) crc = (crc >> 8) ^ tables[0][(crc ^ std::to_integer<std::uint32_t>(*data)) & 0xFF];
+
+            return crc;
+        }
+
+#ifdef MYAKISH_CRC32C_SSE42
+#ifndef _MSC_VER
+        __attribute__((target("sse4.2")))
+#endif
+        inline std::uint32_t Crc32cHardware(std::uint32_t crc, const std::byte* data, Size size)
+        {
+            std::uint64_t wide = crc;
+
+            for (; size >= 8; data += 8, size -= 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data, 8);
+
+                wide = _mm_crc32_u64(wide, word);
+            }
+
+            crc = static_cast<std::uint32_t>(wide);
+            for (; size > 0; data++, size--) crc = _mm_crc32_u8(crc, std::to_integer<std::uint8_t>(*data));
+
+            return crc;
+        }
+
+        inline bool HasSse42()
+        {
+            static const bool supported = []
+                {
+#ifdef _MSC_VER
+                    int info[4];
+                    __cpuid(info, 1);
+                    return ((info[2] >> 20) & 1) != 0;
+#else
+                    return __builtin_cpu_supports("sse4.2") != 0;
+#endif
+                }();
+
+            return supported;
+        }
+#endif
+    }
+
+    template<typename Type>
+    concept StreamHash = requires(Type hash, const std::byte* data, Size size)
+    {
+        hash.Update(data, size);
+        hash.Value();
+    };
+
+    class Crc32c
+    {
+        std::uint32_t state = ~0u;
+
+    public:
+
+        void Update(const std::byte* data, Size size)
+        {
+#ifdef MYAKISH_CRC32C_SSE42
+            if (detail::HasSse42())
+            {
+                state = detail::Crc32cHardware(state, data, size);
+                return;
+            }
+#endif
+            state = detail::Crc32cSoftware(state, data, size);
+        }
+
+        std::uint32_t Value() const
+        {
+            return ~state;
+        }
+    };
+    static_assert(StreamHash<Crc32c>, "Crc32c must be StreamHash");
+
+    // Streaming XXH64
+    class XxHash64
+    {
+        inline constexpr static std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+        inline constexpr static std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+        inline constexpr static std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+        inline constexpr static std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+        inline constexpr static std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+        std::uint64_t seed;
+        std::uint64_t lanes[4];
+        std::byte pending[32];
+        Size pendingSize;
+        std::uint64_t total;
+
+        static std::uint64_t Load64(const std::byte* data)
+        {
+            std::uint64_t value;
+            std::memcpy(&value, data, 8);
+
+            if constexpr (std::endian::native == std::endian::big) value = std::byteswap(value);
+            return value;
+        }
+
+        static std::uint32_t Load32(const std::byte* data)
+        {
+            std::uint32_t value;
+            std::memcpy(&value, data, 4);
+
+            if constexpr (std::endian::native == std::endian::big) value = std::byteswap(value);
+            return value;
+        }
+
+        static std::uint64_t Round(std::uint64_t accumulator, std::uint64_t input)
+        {
+            return std::rotl(accumulator + input * Prime2, 31) * Prime1;
+        }
+
+        static std::uint64_t Merge(std::uint64_t accumulator, std::uint64_t lane)
+        {
+            return (accumulator ^ Round(0, lane)) * Prime1 + Prime4;
+        }
+
+        void Consume(const std::byte* stripe)
+        {
+            for (int i = 0; i < 4; i++) lanes[i] = Round(lanes[i], Load64(stripe + i * 8));
+        }
+
+    public:
+
+        explicit XxHash64(std::uint64_t seed = 0) :
+            seed(seed), lanes{ seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1 }, pending{}, pendingSize(0), total(0) {}
+
+        void Update(const std::byte* data, Size size)
+        {
+            total += size;
+
+            if (pendingSize + size < 32)
+            {
+                std::memcpy(pending + pendingSize, data, size);
+                pendingSize += size;
+                return;
+            }
+
+            if (pendingSize > 0)
+            {
+                auto fill = 32 - pendingSize;
+                std::memcpy(pending + pendingSize, data, fill);
+                Consume(pending);
+
+                data += fill;
+                size -= fill;
+                pendingSize = 0;
+            }
+
+            for (; size >= 32; data += 32, size -= 32) Consume(data);
+
+            std::memcpy(pending, data, size);
+            pendingSize = size;
+        }
+
+        std::uint64_t Value() const
+        {
+            std::uint64_t hash;
+
+            if (total >= 32)
+            {
+                hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+                for (auto lane : lanes) hash = Merge(hash, lane);
+            }
+            else hash = seed + Prime5;
+
+            hash += total;
+
+            auto data = pending;
+            auto size = pendingSize;
+
+            for (; size >= 8; data += 8, size -= 8) hash = std::rotl(hash ^ Round(0, Load64(data)), 27) * Prime1 + Prime4;
+            for (; size >= 4; data += 4, size -= 4) hash = std::rotl(hash ^ (Load32(data) * Prime1), 23) * Prime2 + Prime3;
+            for (; size > 0; data++, size--) hash = std::rotl(hash ^ (std::to_integer<std::uint64_t>(*data) * Prime5), 11) * Prime1;
+
+            hash ^= hash >> 33;
+            hash *= Prime2;
+            hash ^= hash >> 29;
+            hash *= Prime3;
+            hash ^= hash >> 32;
+
+            return hash;
+        }
+    };
+    static_assert(StreamHash<XxHash64>, "XxHash64 must be StreamHash");
+
+    // Bytes handed out by Write(Size) are hashed lazily, before the next operation touches the underlying stream
+    template<Stream Underlying, StreamHash Hash = Crc32c>
+    class ChecksumStream
+    {
+    public:
+
+        ChecksumStream(Underlying stream, Hash hash = {}) : stream(std::forward<Underlying>(stream)), hash(std::move(hash)), pending(nullptr), pendingSize(0) {}
+
+        void Write(const std::byte* src, Size size) requires OutputStream<Underlying>
+        {
+            Settle();
+
+            hash.Update(src, size);
+            streams::Write(stream, src, size);
+        }
+
+        std::byte* Write(Size size) requires PointerOutputStream<Underlying>
+        {
+            Settle();
+
+            pending = streams::Write(stream, size);
+            pendingSize = size;
+
+            return pending;
+        }
+
+        void Read(std::byte* dst, Size size) requires InputStream<Underlying>
+        {
+            streams::Read(stream, dst, size);
+            hash.Update(dst, size);
+        }
+
+        const std::byte* Read(Size size) requires PointerInputStream<Underlying>
+        {
+            auto data = streams::Read(stream, size);
+            hash.Update(data, size);
+
+            return data;
+        }
+
+        // Values handed to a layer below are hashed as the caller sees them, before any reinterpretation
+        template<typename Type>
+        Type ReadValue() requires requires(Underlying& stream) { { stream.template ReadValue<Type>() } -> std::same_as<Type>; }
+        {
+            auto value = stream.template ReadValue<Type>();
+            hash.Update(reinterpret_cast<const std::byte*>(&value), sizeof(Type));
+
+            return value;
+        }
+
+        template<typename Type>
+        void WriteValue(Type value) requires requires(Underlying& stream) { stream.WriteValue(value); }
+        {
+            Settle();
+
+            hash.Update(reinterpret_cast<const std::byte*>(&value), sizeof(Type));
+            stream.WriteValue(value);
+        }
+
+        template<typename Type>
+        void ReadArray(Type* values, Size count) requires requires(Underlying& stream) { stream.ReadArray(values, count); }
+        {
+            stream.ReadArray(values, count);
+            hash.Update(reinterpret_cast<const std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+        }
+
+        template<typename Type>
+        void WriteArray(const Type* values, Size count) requires requires(Underlying& stream) { stream.WriteArray(values, count); }
+        {
+            Settle();
+
+            hash.Update(reinterpret_cast<const std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+            stream.WriteArray(values, count);
+        }
+
+        // Skipped input is still hashed, skipped output hashes as the zeros it produces
+        void Seek(Size size)
+        {
+            Settle();
+
+            if constexpr (PointerInputStream<Underlying>) Read(size);
+            else if constexpr (InputStream<Underlying>)
+            {
+                std::byte buffer[4096];
+
+                for (; size > 0; size -= std::min<Size>(size, sizeof buffer)) Read(buffer, std::min<Size>(size, sizeof buffer));
+            }
+            else
+            {
+                static constexpr std::byte zeros[4096]{};
+
+                for (auto left = size; left > 0; left -= std::min<Size>(left, sizeof zeros)) hash.Update(zeros, std::min<Size>(left, sizeof zeros));
+                streams::Seek(stream, size);
+            }
+        }
+
+        Size Offset() const requires AlignableStream<Underlying>
+        {
+            return streams::Offset(stream);
+        }
+
+        Size Length() const requires SizedStream<Underlying>
+        {
+            return streams::Length(stream);
+        }
+
+        void Reserve(Size size) requires ReservableStream<Underlying>
+        {
+            Settle();
+            streams::Reserve(stream, size);
+        }
+
+        bool Valid() const requires requires(const Underlying& stream) { stream.Valid(); }
+        {
+            return stream.Valid();
+        }
+
+        auto Checksum()
+        {
+            Settle();
+            return hash.Value();
+        }
+
+        Underlying& Base()
+        {
+            Settle();
+            return stream;
+        }
+
+    private:
+
+        Underlying stream;
+        Hash hash;
+
+        std::byte* pending;
+        Size pendingSize;
+
+        void Settle()
+        {
+            if (!pending) return;
+
+            hash.Update(pending, pendingSize);
+            pending = nullptr;
+        }
+    };
+
+    template<Stream Underlying>
+    ChecksumStream(Underlying&&) -> ChecksumStream<Underlying>;
+
+    template<Stream Underlying, StreamHash Hash>
+    ChecksumStream(Underlying&&, Hash) -> ChecksumStream<Underlying, Hash>;
+
+    static_assert(PointerOutputStream<ChecksumStream<PointerOutputStreamArchetype>>, "ChecksumStream must be PointerOutputStream");
+    static_assert(PointerInputStream<ChecksumStream<PointerInputStreamArchetype>>, "ChecksumStream must be PointerInputStream");
+    static_assert(SizedStream<ChecksumStream<SizedStreamArchetype>>, "ChecksumStream must be SizedStream");
+    static_assert(AlignableStream<ChecksumStream<AlignableStreamArchetype>>, "ChecksumStream must be AlignableStream");
+    static_assert(ReservableStream<ChecksumStream<ReservableStreamArchetype>>, "ChecksumStream must be ReservableStream");
+
+    struct ChecksummedFunctor : functional::ExtensionMethod
+    {
+        template<Stream Underlying, StreamHash Hash = Crc32c>
+        auto operator()(Underlying&& stream, Hash hash = {}) const
+        {
+            return ChecksumStream<Underlying, Hash>(std::forward<Underlying>(stream), std::move(hash));
+        }
+    };
+    inline constexpr ChecksummedFunctor Checksummed;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+namespace myakish::streams
+{
+    // Writes shorter than Capacity are gathered and forwarded in one piece; longer ones go straight through
+    template<OutputStream Underlying, Size Capacity = 4096>
+    class CoalescingStream
+    {
+    public:
+
+        CoalescingStream(Underlying stream) : stream(std::forward<Underlying>(stream)), used(0) {}
+
+        CoalescingStream(CoalescingStream&& rhs) noexcept : stream(std::forward<Underlying>(rhs.stream)), used(std::exchange(rhs.used, 0)), spill(std::move(rhs.spill))
+        {
+            std::memcpy(buffer, rhs.buffer, used);
+            rhs.spill.clear();
+        }
+
+        CoalescingStream(const CoalescingStream&) = delete;
+
+        ~CoalescingStream()
+        {
+            Flush();
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            if (!spill.empty()) Flush();
+
+            if (used + size <= Capacity)
+            {
+                std::memcpy(buffer + used, src, size);
+                used += size;
+                return;
+            }
+
+            Flush();
+
+            if (size >= Capacity) streams::Write(stream, src, size);
+            else
+            {
+                std::memcpy(buffer, src, size);
+                used = size;
+            }
+        }
+
+        // Oversized regions come from the underlying stream when it can hand out memory, from a spill buffer otherwise
+        std::byte* Write(Size size)
+        {
+            if (!spill.empty()) Flush();
+
+            if (used + size <= Capacity) return buffer + std::exchange(used, used + size);
+
+            Flush();
+
+            if (size <= Capacity)
+            {
+                used = size;
+                return buffer;
+            }
+
+            if constexpr (PointerOutputStream<Underlying>) return streams::Write(stream, size);
+            else
+            {
+                spill.resize(size);
+                return spill.data();
+            }
+        }
+
+        // Values for a layer below are not plain bytes, so the buffer goes out first to keep the order;
+        // coalescing underneath such a layer keeps the batching
+        template<typename Type>
+        void WriteValue(Type value) requires requires(Underlying& stream) { stream.WriteValue(value); }
+        {
+            Flush();
+            stream.WriteValue(value);
+        }
+
+        template<typename Type>
+        void WriteArray(const Type* values, Size count) requires requires(Underlying& stream) { stream.WriteArray(values, count); }
+        {
+            Flush();
+            stream.WriteArray(values, count);
+        }
+
+        std::span<std::byte> Acquire(Size size)
+        {
+            if (!spill.empty()) Flush();
+
+            if (used + size > Capacity) Flush();
+
+            if (size <= Capacity)
+            {
+                acquired = Region::Buffer;
+                return { buffer + used, static_cast<std::size_t>(size) };
+            }
+
+            if constexpr (TransactionalStream<Underlying>)
+            {
+                acquired = Region::Forwarded;
+                return streams::Acquire(stream, size);
+            }
+            else
+            {
+                acquired = Region::Spill;
+                spill.resize(size);
+                return spill;
+            }
+        }
+
+        void Commit(Size size)
+        {
+            switch (acquired)
+            {
+            case Region::Buffer:
+                used += size;
+                break;
+            case Region::Spill:
+                spill.resize(size);
+                break;
+            case Region::Forwarded:
+                if constexpr (TransactionalStream<Underlying>) streams::Commit(stream, size);
+                break;
+            }
+        }
+
+        void Seek(Size size)
+        {
+            if (!spill.empty()) Flush();
+
+            if (used + size <= Capacity)
+            {
+                std::memset(buffer + used, 0, size);
+                used += size;
+                return;
+            }
+
+            Flush();
+            streams::Seek(stream, size);
+        }
+
+        Size Offset() const requires AlignableStream<Underlying>
+        {
+            return streams::Offset(stream) + used + static_cast<Size>(spill.size());
+        }
+
+        void Reserve(Size size) requires ReservableStream<Underlying>
+        {
+            streams::Reserve(stream, size);
+        }
+
+        void Flush()
+        {
+            if (used > 0) streams::Write(stream, buffer, std::exchange(used, 0));
+
+            if (!spill.empty())
+            {
+                streams::Write(stream, spill.data(), static_cast<Size>(spill.size()));
+                spill.clear();
+            }
+        }
+
+        bool Valid() const requires requires(const Underlying& stream) { stream.Valid(); }
+        {
+            return stream.Valid();
+        }
+
+        Underlying& Base()
+        {
+            Flush();
+            return stream;
+        }
+
+    private:
+
+        enum class Region
+        {
+            Buffer,
+            Spill,
+            Forwarded
+        };
+
+        alignas(CacheLineSize) std::byte buffer[Capacity];
+
+        Underlying stream;
+        Size used;
+        std::vector<std::byte> spill;
+        Region acquired = Region::Buffer;
+    };
+
+    template<OutputStream Underlying>
+    CoalescingStream(Underlying&&) -> CoalescingStream<Underlying>;
+
+    static_assert(PointerOutputStream<CoalescingStream<OutputStreamArchetype>>, "CoalescingStream must be PointerOutputStream");
+    static_assert(AlignableStream<CoalescingStream<CombinedArchetype<AlignableStreamArchetype, OutputStreamArchetype>>>, "CoalescingStream must be AlignableStream");
+    static_assert(ReservableStream<CoalescingStream<ReservableStreamArchetype>>, "CoalescingStream must be ReservableStream");
+    static_assert(TransactionalStream<CoalescingStream<OutputStreamArchetype>>, "CoalescingStream must be TransactionalStream");
+
+    struct CoalescedFunctor : functional::ExtensionMethod
+    {
+        template<OutputStream Underlying>
+        auto operator()(Underlying&& stream) const
+        {
+            return CoalescingStream<Underlying>(std::forward<Underlying>(stream));
+        }
+    };
+    inline constexpr CoalescedFunctor Coalesced;
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <ranges>
+#include <span>
 
 #include <MyakishLibrary/Meta.hpp>
 
@@ -16,6 +20,8 @@ namespace fs = std::filesystem;
 
 namespace myakish::streams
 {
+    inline constexpr Size CacheLineSize = 64;
+
     template<bool Const>
     struct ContiguousStream
     {
@@ -34,6 +40,16 @@ namespace myakish::streams
             return std::exchange(data, data + size);
         }
 
+        std::span<std::byte> Acquire(Size size) requires !Const
+        {
+            return { data, static_cast<std::size_t>(size) };
+        }
+
+        void Commit(Size used) requires !Const
+        {
+            data += used;
+        }
+
         const std::byte* Read(Size size)
         {
             return std::exchange(data, data + size);
@@ -66,6 +82,7 @@ namespace myakish::streams
         }
     };
     static_assert(PointerOutputStream<ContiguousStream<false>>, "non-const ContiguousStream must be OutputStream");
+    static_assert(TransactionalStream<ContiguousStream<false>>, "non-const ContiguousStream must be TransactionalStream");
     static_assert(PointerInputStream<ContiguousStream<true>>, "const ContiguousStream must be InputStream");
     static_assert(SizedStream<ContiguousStream<true>>, "const ContiguousStream must be SizedStream");
     static_assert(PersistentDataStream<ContiguousStream<true>>, "const ContiguousStream must be PersistentDataStream");
@@ -101,6 +118,112 @@ namespace myakish::streams
     };
     static_assert(ReservableStream<VectorOutputStream>, "VectorOutputStream must be ReservableStream");
 
+    struct ByteBuffer
+    {
+        std::unique_ptr<std::byte[]> storage;
+        Size size;
+        Size capacity;
+
+        std::byte* Data() const
+        {
+            return storage.get();
+        }
+
+        Size Length() const
+        {
+            return size;
+        }
+
+        std::span<const std::byte> Bytes() const
+        {
+            return { storage.get(), static_cast<std::size_t>(size) };
+        }
+    };
+
+    struct BufferOutputStream
+    {
+        inline constexpr static Size InitialCapacity = 256;
+
+        std::unique_ptr<std::byte[]> storage;
+        Size size;
+        Size capacity;
+
+        BufferOutputStream() : size(0), capacity(0) {}
+        explicit BufferOutputStream(Size reserve) : BufferOutputStream()
+        {
+            Reserve(reserve);
+        }
+
+        std::byte* Write(Size count)
+        {
+            if (size + count > capacity) Grow(size + count);
+            return storage.get() + std::exchange(size, size + count);
+        }
+
+        void Write(const std::byte* src, Size count)
+        {
+            std::memcpy(Write(count), src, count);
+        }
+
+        std::span<std::byte> Acquire(Size count)
+        {
+            Reserve(count);
+            return { storage.get() + size, static_cast<std::size_t>(count) };
+        }
+
+        void Commit(Size used)
+        {
+            size += used;
+        }
+
+        void Seek(Size count)
+        {
+            std::memset(Write(count), 0, count);
+        }
+
+        void Reserve(Size reserve)
+        {
+            if (size + reserve > capacity) Grow(size + reserve);
+        }
+
+        Size Offset() const
+        {
+            return size;
+        }
+
+        std::span<const std::byte> Bytes() const
+        {
+            return { storage.get(), static_cast<std::size_t>(size) };
+        }
+
+        void Clear()
+        {
+            size = 0;
+        }
+
+        ByteBuffer Release()
+        {
+            return { std::move(storage), std::exchange(size, 0), std::exchange(capacity, 0) };
+        }
+
+    private:
+
+        void Grow(Size required)
+        {
+            auto grown = std::max({ required, 2 * capacity, InitialCapacity });
+            auto replacement = std::make_unique_for_overwrite<std::byte[]>(grown);
+
+            if (size) std::memcpy(replacement.get(), storage.get(), size);
+
+            storage = std::move(replacement);
+            capacity = grown;
+        }
+    };
+    static_assert(PointerOutputStream<BufferOutputStream>, "BufferOutputStream must be PointerOutputStream");
+    static_assert(TransactionalStream<BufferOutputStream>, "BufferOutputStream must be TransactionalStream");
+    static_assert(ReservableStream<BufferOutputStream>, "BufferOutputStream must be ReservableStream");
+    static_assert(AlignableStream<BufferOutputStream>, "BufferOutputStream must be AlignableStream");
+
 
     template<Stream Underlying>
     struct AlignableWrapper
@@ -190,6 +313,16 @@ namespace myakish::streams
             streams::Write(stream, src, size);
         }
 
+        std::span<std::byte> Acquire(Size size) requires TransactionalStream<Underlying>
+        {
+            return streams::Acquire(stream, size);
+        }
+
+        void Commit(Size used) requires TransactionalStream<Underlying>
+        {
+            streams::Commit(stream, used);
+        }
+
         void Reserve(Size reserve) requires ReservableStream<Underlying>
         {
             streams::Reserve(stream, reserve);
@@ -204,6 +337,7 @@ namespace myakish::streams
     static_assert(SizedStream<WriteOnlyWrapper<CombinedArchetype<SizedStreamArchetype, OutputStreamArchetype>>>, "WriteOnlyWrapper must be RandomAccessStream");
     static_assert(OutputStream<WriteOnlyWrapper<OutputStreamArchetype>>, "WriteOnlyWrapper must be OutputStream");
     static_assert(ReservableStream<WriteOnlyWrapper<ReservableStreamArchetype>>, "WriteOnlyWrapper must be ReservableStream");
+    static_assert(TransactionalStream<WriteOnlyWrapper<TransactionalStreamArchetype>>, "WriteOnlyWrapper must be TransactionalStream");
 
     inline constexpr auto WriteOnly = functional::DeduceConstruct<WriteOnlyWrapper>;
 
@@ -292,11 +426,34 @@ namespace myakish::streams
     
     struct CopyFunctor : functional::ExtensionMethod
     {
-        constexpr void operator()(InputStream auto&& in, OutputStream auto&& out, Size bytes) const
+        inline constexpr static Size ChunkSize = 1 << 16;
+
+        void operator()(InputStream auto&& in, OutputStream auto&& out, Size bytes) const
+        {
+            using In = decltype(in);
+            using Out = decltype(out);
+
+            if constexpr (requires { out.CopyFrom(in, bytes); }) out.CopyFrom(in, bytes);
+            else if constexpr (PersistentDataStream<In>) Write(out, Read(in, bytes), bytes);
+            else if constexpr (PointerInputStream<In>) Chunked(bytes, [&](Size count) { Write(out, Read(in, count), count); });
+            else if constexpr (PointerOutputStream<Out>) Chunked(bytes, [&](Size count) { Read(in, Write(out, count), count); });
+            else
+            {
+                thread_local auto buffer = std::make_unique_for_overwrite<std::byte[]>(ChunkSize);
+
+                Chunked(bytes, [&](Size count)
+                    {
+                        Read(in, buffer.get(), count);
+                        Write(out, buffer.get(), count);
+                    });
+            }
+        }
+
+    private:
+
+        static void Chunked(Size bytes, auto&& step)
         {
-            std::vector<std::byte> buffer(bytes);
-            in.Read(buffer.data(), bytes);
-            out.Write(buffer.data(), bytes);
+            for (; bytes > 0; bytes -= ChunkSize) step(std::min(bytes, ChunkSize));
         }
     };
     inline constexpr CopyFunctor Copy;
@@ -305,7 +462,13 @@ namespace myakish::streams
     {
         constexpr void operator()(OutputStream auto&& out, myakish::meta::TriviallyCopyableConcept auto value) const
         {
-            Write(out, reinterpret_cast<const std::byte*>(&value), sizeof(value));
+            if constexpr (requires { out.WriteValue(value); }) out.WriteValue(value);
+            else if constexpr (TransactionalStream<decltype(out)>)
+            {
+                std::memcpy(Acquire(out, sizeof(value)).data(), &value, sizeof(value));
+                Commit(out, sizeof(value));
+            }
+            else Write(out, reinterpret_cast<const std::byte*>(&value), sizeof(value));
         }
 
         constexpr void operator()(OutputStream auto&& out, std::string_view str) const
@@ -320,7 +483,13 @@ namespace myakish::streams
     {
         constexpr void operator()(OutputStream auto&& out, Type value) const
         {
-            Write(out, reinterpret_cast<const std::byte*>(&value), sizeof(value));
+            if constexpr (requires { out.WriteValue(value); }) out.WriteValue(value);
+            else if constexpr (TransactionalStream<decltype(out)>)
+            {
+                std::memcpy(Acquire(out, sizeof(value)).data(), &value, sizeof(value));
+                Commit(out, sizeof(value));
+            }
+            else Write(out, reinterpret_cast<const std::byte*>(&value), sizeof(value));
         }
 
         constexpr void operator()(OutputStream auto&& out, std::string_view str) const requires std::same_as<Type, std::string_view>
@@ -336,14 +505,46 @@ namespace myakish::streams
     {
         constexpr Type operator()(InputStream auto&& in) const
         {
-            Type result;
-            Read(in, reinterpret_cast<std::byte*>(&result), sizeof(result));
-            return result;
+            if constexpr (requires { { in.template ReadValue<Type>() } -> std::same_as<Type>; }) return in.template ReadValue<Type>();
+            else
+            {
+                Type result;
+                Read(in, reinterpret_cast<std::byte*>(&result), sizeof(result));
+                return result;
+            }
         }
     };
     template<myakish::meta::TriviallyCopyableConcept Type>
     inline constexpr ReadTrivialFunctor<Type> ReadTrivial;
 
+    // Streams that reinterpret values (byte order, ...) see whole arrays instead of raw bytes.
+    // Wrappers forward the value members to them, and raw-byte shortcuts must not go around them
+    template<typename Type>
+    concept ValueStream = requires(Type& stream, std::uint32_t* values, Size count) { stream.ReadArray(values, count); } ||
+        requires(Type& stream, const std::uint32_t* values, Size count) { stream.WriteArray(values, count); };
+
+    struct ReadArrayFunctor : functional::ExtensionMethod
+    {
+        template<myakish::meta::TriviallyCopyableConcept Type>
+        constexpr void operator()(InputStream auto&& in, Type* values, Size count) const
+        {
+            if constexpr (requires { in.ReadArray(values, count); }) in.ReadArray(values, count);
+            else Read(in, reinterpret_cast<std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+        }
+    };
+    inline constexpr ReadArrayFunctor ReadArray;
+
+    struct WriteArrayFunctor : functional::ExtensionMethod
+    {
+        template<myakish::meta::TriviallyCopyableConcept Type>
+        constexpr void operator()(OutputStream auto&& out, const Type* values, Size count) const
+        {
+            if constexpr (requires { out.WriteArray(values, count); }) out.WriteArray(values, count);
+            else Write(out, reinterpret_cast<const std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+        }
+    };
+    inline constexpr WriteArrayFunctor WriteArray;
+
     struct AlignFunctor : functional::ExtensionMethod
     {
         constexpr void operator()(AlignableStream auto&& stream, Size alignment) const
@@ -462,25 +663,47 @@ namespace myakish::streams
 
         RangeInputStream(Range&& range) : range(std::forward<Range>(range)), iterator(std::ranges::begin(range)), offset{ 0 } {}
 
+        // iterator always points at the element holding the next byte; offset is in [0, ValueSize)
         void Read(std::byte* dst, Size size)
         {
-            while (size)
+            if constexpr (std::ranges::contiguous_range<Range>)
             {
-                auto currentLeft = ValueSize - offset;
-                if (currentLeft == 0)
+                std::memcpy(dst, AsBytePtr(std::to_address(iterator)) + offset, size);
+
+                Seek(size);
+                return;
+            }
+            else
+            {
+                if (offset != 0)
                 {
-                    iterator++;
+                    auto head = std::min(ValueSize - offset, size);
+
+                    Value current = *iterator;
+                    std::memcpy(std::exchange(dst, dst + head), AsBytePtr(&current) + offset, head);
+
+                    offset += head;
+                    size -= head;
+
+                    if (offset != ValueSize) return;
+
+                    ++iterator;
                     offset = 0;
-                    currentLeft = ValueSize;
                 }
 
-                auto toCopy = std::min(currentLeft, size);
+                for (; size >= ValueSize; size -= ValueSize, ++iterator)
+                {
+                    Value current = *iterator;
+                    std::memcpy(std::exchange(dst, dst + ValueSize), AsBytePtr(&current), ValueSize);
+                }
 
-                Value current = *iterator;
-                memcpy(std::exchange(dst, dst + toCopy), AsBytePtr(&current) + offset, toCopy);
+                if (size)
+                {
+                    Value current = *iterator;
+                    std::memcpy(dst, AsBytePtr(&current), size);
 
-                offset += toCopy;
-                size -= toCopy;
+                    offset = size;
+                }
             }
         }
 
@@ -491,21 +714,16 @@ namespace myakish::streams
 
         void Seek(Size size)
         {
-            auto currentLeft = ValueSize - offset;
-            auto toCopy = std::min(currentLeft, size);
-            size -= toCopy;
-            offset += toCopy;
+            auto target = offset + size;
 
-            if (size)
-            {
-                std::ranges::advance(iterator, size / ValueSize);
-                offset = size % ValueSize;
-            }
+            std::ranges::advance(iterator, target / ValueSize);
+            offset = target % ValueSize;
         }
-
-
     };
 
+    template<std::ranges::input_range Range>
+    RangeInputStream(Range&&) -> RangeInputStream<Range>;
+
     template<std::ranges::range Range> 
     struct RangeOutputStream
     {
@@ -523,24 +741,31 @@ namespace myakish::streams
         RangeOutputStream(Range&& range) : range(std::forward<Range>(range)), iterator(std::ranges::begin(range)), offset{ 0 } {}
 
         void Write(const std::byte* src, Size size)
-        {     
-            while (size)
-            {              
-                auto currentLeft = ValueSize - offset;
+        {
+            if (offset != 0)
+            {
+                auto head = std::min(ValueSize - offset, size);
+                std::memcpy(AsBytePtr(&value) + offset, std::exchange(src, src + head), head);
 
-                auto toCopy = std::min(currentLeft, size);
-                std::memcpy(AsBytePtr(&value) + offset, std::exchange(src, src + toCopy), toCopy);
+                offset += head;
+                size -= head;
 
-                offset += toCopy;
-                size -= toCopy;
-                
-                currentLeft = ValueSize - offset;
-                
-                if (currentLeft == 0)
-                {
-                    *iterator++ = value;
-                    offset = 0;
-                }
+                if (offset != ValueSize) return;
+
+                *iterator++ = value;
+                offset = 0;
+            }
+
+            for (; size >= ValueSize; size -= ValueSize)
+            {
+                std::memcpy(AsBytePtr(&value), std::exchange(src, src + ValueSize), ValueSize);
+                *iterator++ = value;
+            }
+
+            if (size)
+            {
+                std::memcpy(AsBytePtr(&value), src, size);
+                offset = size;
             }
         }
 
@@ -574,9 +799,98 @@ namespace myakish::streams
 
     };
 
+    template<std::ranges::range Range>
+    RangeOutputStream(Range&&) -> RangeOutputStream<Range>;
+
+    namespace detail
+    {
+        template<typename Type>
+        struct IsJoinView : std::false_type {};
+
+        template<typename View>
+        struct IsJoinView<std::ranges::join_view<View>> : std::true_type {};
+
+        // ranges of contiguous runs of trivial values, except plain arrays of trivially copyable owning values
+        template<typename Range>
+        concept SegmentedRange = std::ranges::input_range<Range> &&
+            std::ranges::contiguous_range<std::ranges::range_reference_t<Range>> &&
+            std::ranges::sized_range<std::ranges::range_reference_t<Range>> &&
+            meta::TriviallyCopyableConcept<std::ranges::range_value_t<std::ranges::range_reference_t<Range>>> &&
+            (!std::ranges::contiguous_range<Range> || !meta::TriviallyCopyableConcept<std::ranges::range_value_t<Range>> || std::ranges::view<std::ranges::range_value_t<Range>>);
+
+        template<typename Range>
+        concept JoinedSegments = std::ranges::input_range<Range> && IsJoinView<std::remove_cvref_t<Range>>::value &&
+            SegmentedRange<decltype(std::declval<Range>().base())>;
+    }
+
+    template<std::ranges::input_range Range, bool Const>
+    struct SegmentedRangeStream
+    {
+        using Segments = std::views::all_t<Range>;
+        using Iterator = std::ranges::iterator_t<Segments>;
+        using DataType = std::conditional_t<Const, const std::byte, std::byte>;
+
+        Segments segments;
+        Iterator segment;
+        Size offset;
+
+        SegmentedRangeStream(Range&& range) : segments(std::views::all(std::forward<Range>(range))), segment(std::ranges::begin(segments)), offset(0) {}
+
+        void Read(std::byte* dst, Size size)
+        {
+            Transfer(size, [&](DataType* run, Size count)
+                {
+                    std::memcpy(std::exchange(dst, dst + count), run, count);
+                });
+        }
+
+        void Write(const std::byte* src, Size size) requires (!Const)
+        {
+            Transfer(size, [&](std::byte* run, Size count)
+                {
+                    std::memcpy(run, std::exchange(src, src + count), count);
+                });
+        }
+
+        void Seek(Size size)
+        {
+            Transfer(size, [](DataType*, Size) {});
+        }
+
+        bool Valid() const
+        {
+            return segment != std::ranges::end(segments);
+        }
+
+    private:
+
+        void Transfer(Size size, auto&& step)
+        {
+            while (size && segment != std::ranges::end(segments))
+            {
+                auto&& current = *segment;
+
+                using Element = std::ranges::range_value_t<decltype(current)>;
+                auto bytes = static_cast<Size>(std::ranges::size(current) * sizeof(Element));
+
+                auto count = std::min(bytes - offset, size);
+                if (count) step(reinterpret_cast<DataType*>(std::ranges::data(current)) + offset, count);
+
+                offset += count;
+                size -= count;
+
+                if (offset == bytes)
+                {
+                    ++segment;
+                    offset = 0;
+                }
+            }
+        }
+    };
+
     struct ReadFromRangeFunctor : functional::ExtensionMethod
     {
-        template<std::ranges::contiguous_range Range>
+        template<std::ranges::contiguous_range Range> requires (!detail::SegmentedRange<Range>)
         auto operator()(Range&& r) const
         {
             auto data = AsBytePtr(std::ranges::data(r));
@@ -585,6 +899,18 @@ namespace myakish::streams
             return ContiguousStream<true>(data, data + size);
         }
 
+        template<detail::SegmentedRange Range>
+        auto operator()(Range&& r) const
+        {
+            return SegmentedRangeStream<Range, true>(std::forward<Range>(r));
+        }
+
+        template<detail::JoinedSegments Range>
+        auto operator()(Range&& r) const
+        {
+            return SegmentedRangeStream<decltype(r.base()), true>(r.base());
+        }
+
         template<std::ranges::input_range Range>
         auto operator()(Range&& r) const
         {
@@ -595,7 +921,7 @@ namespace myakish::streams
 
     struct WriteToRangeFunctor : functional::ExtensionMethod
     {
-        template<std::ranges::contiguous_range Range>
+        template<std::ranges::contiguous_range Range> requires (!detail::SegmentedRange<Range>)
         auto operator()(Range&& r) const
         {
             auto data = AsBytePtr(std::ranges::data(r));
@@ -604,6 +930,12 @@ namespace myakish::streams
             return ContiguousStream<false>(data, data + size);
         }
 
+        template<detail::SegmentedRange Range> requires (!std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<std::ranges::range_reference_t<Range>>>>)
+        auto operator()(Range&& r) const
+        {
+            return SegmentedRangeStream<Range, false>(std::forward<Range>(r));
+        }
+
         template<std::ranges::range Range>
         auto operator()(Range&& r) const
         {
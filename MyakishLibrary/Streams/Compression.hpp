@@ -0,0 +1,644 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Async.hpp>
+
+namespace myakish::streams
+{
+    // LZ4-style block format: token (literal length << 4 | match length - 4), 255-run length extensions, 16-bit offsets.
+    // The last sequence carries literals only
+    struct LzBlockCodec
+    {
+        inline constexpr static Size MinMatch = 4;
+        inline constexpr static Size MaxOffset = 65535;
+        inline constexpr static int HashBits = 14;
+
+        static Size Bound(Size size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        static Size Compress(const std::byte* src, Size size, std::byte* dst)
+        {
+            std::uint32_t table[1 << HashBits]{};
+
+            auto out = dst;
+            Size anchor = 0;
+            Size position = 0;
+            Size misses = 0;
+
+            while (position + MinMatch <= size)
+            {
+                auto sequence = Load32(src + position);
+                auto& slot = table[(sequence * 2654435761u) >> (32 - HashBits)];
+
+                Size candidate = slot;
+                slot = static_cast<std::uint32_t>(position);
+
+                if (candidate >= position || position - candidate > MaxOffset || Load32(src + candidate) != sequence)
+                {
+                    position += 1 + (misses++ >> 6);
+                    continue;
+                }
+
+                auto length = MinMatch;
+                while (position + length < size && src[candidate + length] == src[position + length]) length++;
+
+                out = Sequence(out, src + anchor, position - anchor, position - candidate, length);
+
+                position += length;
+                anchor = position;
+                misses = 0;
+            }
+
+            out = Literals(out, src + anchor, size - anchor);
+            return out - dst;
+        }
+
+        static bool Decompress(const std::byte* src, Size size, std::byte* dst, Size original)
+        {
+            auto end = src + size;
+            auto out = dst;
+            auto outEnd = dst + original;
+
+            while (src < end)
+            {
+                auto token = std::to_integer<Size>(*src++);
+
+                auto literals = token >> 4;
+                if (literals == 15 && !Extend(src, end, literals)) return false;
+
+                if (end - src < literals || outEnd - out < literals) return false;
+
+                std::memcpy(out, src, literals);
+                src += literals;
+                out += literals;
+
+                if (src == end) break;
+                if (end - src < 2) return false;
+
+                auto offset = std::to_integer<Size>(src[0]) | std::to_integer<Size>(src[1]) << 8;
+                src += 2;
+
+                auto length = token & 15;
+                if (length == 15 && !Extend(src, end, length)) return false;
+                length += MinMatch;
+
+                if (offset == 0 || offset > out - dst || outEnd - out < length) return false;
+
+                auto match = out - offset;
+                if (offset >= length) std::memcpy(out, match, length);
+                else for (Size i = 0; i < length; i++) out[i] = match[i];
+
+                out += length;
+            }
+
+            return out == outEnd;
+        }
+
+    private:
+
+        static std::uint32_t Load32(const std::byte* data)
+        {
+            std::uint32_t value;
+            std::memcpy(&value, data, 4);
+            return value;
+        }
+
+        static std::byte* Length(std::byte* out, Size length)
+        {
+            for (; length >= 255; length -= 255) *out++ = std::byte{ 255 };
+            *out++ = static_cast<std::byte>(length);
+            return out;
+        }
+
+        static bool Extend(const std::byte*& src, const std::byte* end, Size& length)
+        {
+            while (true)
+            {
+                if (src == end) return false;
+
+                auto next = std::to_integer<Size>(*src++);
+                length += next;
+
+                if (next != 255) return true;
+            }
+        }
+
+        static std::byte* Literals(std::byte* out, const std::byte* literals, Size count)
+        {
+            *out++ = static_cast<std::byte>(std::min<Size>(count, 15) << 4);
+            if (count >= 15) out = Length(out, count - 15);
+
+            std::memcpy(out, literals, count);
+            return out + count;
+        }
+
+        static std::byte* Sequence(std::byte* out, const std::byte* literals, Size count, Size offset, Size length)
+        {
+            auto token = out++;
+            *token = static_cast<std::byte>(std::min<Size>(count, 15) << 4 | std::min<Size>(length - MinMatch, 15));
+
+            if (count >= 15) out = Length(out, count - 15);
+
+            std::memcpy(out, literals, count);
+            out += count;
+
+            *out++ = static_cast<std::byte>(offset & 0xFF);
+            *out++ = static_cast<std::byte>(offset >> 8);
+
+            if (length - MinMatch >= 15) out = Length(out, length - MinMatch - 15);
+            return out;
+        }
+    };
+
+    namespace detail
+    {
+        // Frame: a native-endian u32 magic and u32 block size, then per block a u32 packed size (top bit set when stored raw)
+        // and u32 raw size; a zero raw size ends the frame. No block is larger than the frame's block size
+        inline constexpr std::uint32_t FrameMagic = 0x315A4C4D;
+        inline constexpr std::uint32_t StoredBlock = 1u << 31;
+        inline constexpr Size MaxBlockSize = 1 << 30;
+
+        struct CompressionPiece
+        {
+            Size raw;
+            Size packed;
+            bool stored;
+        };
+
+        struct CompressionBlock
+        {
+            std::unique_ptr<std::byte[]> raw;
+            std::unique_ptr<std::byte[]> packed;
+            std::vector<CompressionPiece> pieces;
+            Size capacity = 0;
+            Size used = 0;
+            std::atomic<bool> done = false;
+            std::exception_ptr failure;
+
+            void Reserve(Size size)
+            {
+                if (size <= capacity) return;
+
+                raw = std::make_unique_for_overwrite<std::byte[]>(size);
+                packed = std::make_unique_for_overwrite<std::byte[]>(LzBlockCodec::Bound(size));
+                capacity = size;
+            }
+
+            // A block grown past the frame's block size by Write(Size) is split into pieces of at most `limit` bytes.
+            // Stored pieces take no room in `packed`, so compressed ones always fit within Bound(used)
+            void Encode(Size limit)
+            {
+                pieces.clear();
+
+                Size packedAt = 0;
+
+                for (Size at = 0; at < used; at += limit)
+                {
+                    auto size = std::min(limit, used - at);
+                    auto packedSize = LzBlockCodec::Compress(raw.get() + at, size, packed.get() + packedAt);
+
+                    auto stored = packedSize >= size;
+                    pieces.push_back({ size, stored ? size : packedSize, stored });
+
+                    if (!stored) packedAt += packedSize;
+                }
+            }
+        };
+    }
+
+    template<OutputStream Underlying>
+    class CompressingOutputStream
+    {
+    public:
+
+        inline constexpr static Size DefaultBlockSize = 1 << 18;
+        inline constexpr static std::size_t MaxInFlight = 16;
+
+        // With a pool, blocks are compressed on its workers and written in order
+        CompressingOutputStream(Underlying stream, Size blockSize = DefaultBlockSize, IoService* pool = nullptr) :
+            stream(std::forward<Underlying>(stream)), blockSize(std::clamp<Size>(blockSize, 1, detail::MaxBlockSize)), pool(pool), offset(0), closed(false)
+        {
+            std::uint32_t frame[2] = { detail::FrameMagic, static_cast<std::uint32_t>(this->blockSize) };
+            streams::Write(this->stream, reinterpret_cast<const std::byte*>(frame), sizeof frame);
+
+            current = Take();
+        }
+
+        CompressingOutputStream(const CompressingOutputStream&) = delete;
+
+        ~CompressingOutputStream()
+        {
+            Close();
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            offset += size;
+
+            while (size > 0)
+            {
+                if (current->used == current->capacity) Submit();
+
+                auto count = std::min(size, current->capacity - current->used);
+                std::memcpy(current->raw.get() + current->used, src, count);
+                current->used += count;
+
+                src += count;
+                size -= count;
+            }
+        }
+
+        std::byte* Write(Size size)
+        {
+            offset += size;
+
+            if (current->used + size > current->capacity)
+            {
+                Submit();
+                current->Reserve(size);
+            }
+
+            return current->raw.get() + std::exchange(current->used, current->used + size);
+        }
+
+        void Seek(Size size)
+        {
+            std::memset(Write(size), 0, size);
+        }
+
+        Size Offset() const
+        {
+            return offset;
+        }
+
+        void Flush()
+        {
+            Submit();
+            while (!inFlight.empty()) Drain();
+        }
+
+        void Close()
+        {
+            if (std::exchange(closed, true)) return;
+
+            Flush();
+
+            std::uint32_t header[2]{};
+            streams::Write(stream, reinterpret_cast<const std::byte*>(header), sizeof header);
+        }
+
+        bool Valid() const requires requires(const Underlying& stream) { stream.Valid(); }
+        {
+            return stream.Valid();
+        }
+
+    private:
+
+        using Block = detail::CompressionBlock;
+
+        Underlying stream;
+        Size blockSize;
+        IoService* pool;
+        Size offset;
+        bool closed;
+
+        std::unique_ptr<Block> current;
+        std::deque<std::unique_ptr<Block>> inFlight;
+        std::vector<std::unique_ptr<Block>> spare;
+
+        std::unique_ptr<Block> Take()
+        {
+            if (spare.empty())
+            {
+                auto block = std::make_unique<Block>();
+                block->Reserve(blockSize);
+                return block;
+            }
+
+            auto block = std::move(spare.back());
+            spare.pop_back();
+
+            block->used = 0;
+            block->done.store(false, std::memory_order_relaxed);
+            return block;
+        }
+
+        void Submit()
+        {
+            if (current->used == 0) return;
+
+            if (!pool)
+            {
+                current->Encode(blockSize);
+                Emit(*current);
+
+                current->used = 0;
+                return;
+            }
+
+            auto block = inFlight.emplace_back(std::exchange(current, Take())).get();
+
+            auto Finish = [block]
+                {
+                    block->done.store(true, std::memory_order_release);
+                    block->done.notify_one();
+                };
+
+            pool->Post([block, limit = blockSize, Finish]
+                {
+                    block->Encode(limit);
+                    Finish();
+                },
+                [block, Finish](std::exception_ptr failure)
+                {
+                    block->failure = failure;
+                    Finish();
+                });
+
+            while (inFlight.size() > MaxInFlight) Drain();
+        }
+
+        void Drain()
+        {
+            auto& block = inFlight.front();
+            block->done.wait(false, std::memory_order_acquire);
+
+            auto failure = std::exchange(block->failure, nullptr);
+            if (!failure) Emit(*block);
+
+            spare.push_back(std::move(block));
+            inFlight.pop_front();
+
+            if (failure)
+            {
+                Abandon();
+                std::rethrow_exception(failure);
+            }
+        }
+
+        // A lost block leaves the frame unfinishable: the other workers are waited out so none touches freed blocks
+        void Abandon()
+        {
+            for (auto& block : inFlight)
+            {
+                block->done.wait(false, std::memory_order_acquire);
+                block->failure = nullptr;
+
+                spare.push_back(std::move(block));
+            }
+            inFlight.clear();
+
+            closed = true;
+        }
+
+        void Emit(const Block& block)
+        {
+            Size rawAt = 0;
+            Size packedAt = 0;
+
+            for (auto piece : block.pieces)
+            {
+                std::uint32_t header[2] = { static_cast<std::uint32_t>(piece.packed) | (piece.stored ? detail::StoredBlock : 0), static_cast<std::uint32_t>(piece.raw) };
+                streams::Write(stream, reinterpret_cast<const std::byte*>(header), sizeof header);
+
+                if (piece.stored) streams::Write(stream, block.raw.get() + rawAt, piece.raw);
+                else streams::Write(stream, block.packed.get() + std::exchange(packedAt, packedAt + piece.packed), piece.packed);
+
+                rawAt += piece.raw;
+            }
+        }
+    };
+
+    template<OutputStream Underlying>
+    CompressingOutputStream(Underlying&&) -> CompressingOutputStream<Underlying>;
+
+    template<OutputStream Underlying>
+    CompressingOutputStream(Underlying&&, Size) -> CompressingOutputStream<Underlying>;
+
+    template<OutputStream Underlying>
+    CompressingOutputStream(Underlying&&, Size, IoService*) -> CompressingOutputStream<Underlying>;
+
+    static_assert(PointerOutputStream<CompressingOutputStream<OutputStreamArchetype>>, "CompressingOutputStream must be PointerOutputStream");
+    static_assert(AlignableStream<CompressingOutputStream<OutputStreamArchetype>>, "CompressingOutputStream must be AlignableStream");
+
+    template<InputStream Underlying>
+    class DecompressingInputStream
+    {
+    public:
+
+        DecompressingInputStream(Underlying stream) : stream(std::forward<Underlying>(stream)), blockSize(0), capacity(0), filled(0), cursor(0), offset(0), ended(false), valid(true) {}
+
+        DecompressingInputStream(DecompressingInputStream&& rhs) noexcept = default;
+        DecompressingInputStream(const DecompressingInputStream&) = delete;
+
+        void Read(std::byte* dst, Size size)
+        {
+            while (size > 0)
+            {
+                if (cursor == filled && !Next())
+                {
+                    valid = false;
+                    return;
+                }
+
+                auto count = std::min(size, filled - cursor);
+                std::memcpy(dst, block.get() + cursor, count);
+
+                cursor += count;
+                offset += count;
+                dst += count;
+                size -= count;
+            }
+        }
+
+        const std::byte* Read(Size size)
+        {
+            if (filled - cursor >= size)
+            {
+                offset += size;
+                return block.get() + std::exchange(cursor, cursor + size);
+            }
+
+            if (static_cast<Size>(scratch.size()) < size) scratch.resize(size);
+            Read(scratch.data(), size);
+
+            return scratch.data();
+        }
+
+        // Blocks covered entirely by the seek are skipped without being decoded
+        void Seek(Size size)
+        {
+            while (size > 0)
+            {
+                if (cursor == filled)
+                {
+                    if (!Header())
+                    {
+                        valid = false;
+                        return;
+                    }
+
+                    if (pendingRaw <= size)
+                    {
+                        streams::Seek(stream, pendingPacked);
+
+                        offset += pendingRaw;
+                        size -= pendingRaw;
+                        continue;
+                    }
+
+                    Load();
+                }
+
+                auto count = std::min(size, filled - cursor);
+
+                cursor += count;
+                offset += count;
+                size -= count;
+            }
+        }
+
+        Size Offset() const
+        {
+            return offset;
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+    private:
+
+        Underlying stream;
+
+        std::unique_ptr<std::byte[]> block;
+        std::vector<std::byte> packed;
+        std::vector<std::byte> scratch;
+
+        Size blockSize;
+        Size capacity;
+        Size filled;
+        Size cursor;
+        Size offset;
+
+        Size pendingPacked = 0;
+        Size pendingRaw = 0;
+        bool pendingStored = false;
+
+        bool ended;
+        bool valid;
+
+        bool Intact() const
+        {
+            if constexpr (requires(const Underlying& stream) { stream.Valid(); }) return stream.Valid();
+            else return true;
+        }
+
+        bool Corrupt()
+        {
+            ended = true;
+            valid = false;
+
+            return false;
+        }
+
+        // Sizes are checked against the frame's block size before anything is allocated
+        bool Header()
+        {
+            if (ended) return false;
+
+            if (blockSize == 0)
+            {
+                std::uint32_t frame[2];
+                streams::Read(stream, reinterpret_cast<std::byte*>(frame), sizeof frame);
+
+                if (!Intact() || frame[0] != detail::FrameMagic || frame[1] == 0 || frame[1] > detail::MaxBlockSize) return Corrupt();
+                blockSize = frame[1];
+            }
+
+            std::uint32_t header[2];
+            streams::Read(stream, reinterpret_cast<std::byte*>(header), sizeof header);
+
+            if (!Intact()) return Corrupt();
+
+            pendingStored = header[0] & detail::StoredBlock;
+            pendingPacked = header[0] & ~detail::StoredBlock;
+            pendingRaw = header[1];
+
+            if (pendingRaw > blockSize) return Corrupt();
+            if (pendingStored ? pendingPacked != pendingRaw : pendingPacked > LzBlockCodec::Bound(pendingRaw)) return Corrupt();
+
+            ended = pendingRaw == 0;
+            return !ended;
+        }
+
+        void Load()
+        {
+            if (pendingRaw > capacity)
+            {
+                block = std::make_unique_for_overwrite<std::byte[]>(pendingRaw);
+                capacity = pendingRaw;
+            }
+
+            if (pendingStored) streams::Read(stream, block.get(), pendingRaw);
+            else
+            {
+                packed.resize(pendingPacked);
+                streams::Read(stream, packed.data(), pendingPacked);
+
+                valid &= Intact() && LzBlockCodec::Decompress(packed.data(), pendingPacked, block.get(), pendingRaw);
+            }
+
+            valid &= Intact();
+
+            filled = pendingRaw;
+            cursor = 0;
+        }
+
+        bool Next()
+        {
+            if (!Header()) return false;
+
+            Load();
+            return true;
+        }
+    };
+
+    template<InputStream Underlying>
+    DecompressingInputStream(Underlying&&) -> DecompressingInputStream<Underlying>;
+
+    static_assert(PointerInputStream<DecompressingInputStream<InputStreamArchetype>>, "DecompressingInputStream must be PointerInputStream");
+    static_assert(AlignableStream<DecompressingInputStream<InputStreamArchetype>>, "DecompressingInputStream must be AlignableStream");
+
+    struct CompressedFunctor : functional::ExtensionMethod
+    {
+        template<OutputStream Underlying>
+        auto operator()(Underlying&& stream, Size blockSize = CompressingOutputStream<Underlying>::DefaultBlockSize, IoService* pool = nullptr) const
+        {
+            return CompressingOutputStream<Underlying>(std::forward<Underlying>(stream), blockSize, pool);
+        }
+    };
+    inline constexpr CompressedFunctor Compressed;
+
+    struct DecompressedFunctor : functional::ExtensionMethod
+    {
+        template<InputStream Underlying>
+        auto operator()(Underlying&& stream) const
+        {
+            return DecompressingInputStream<Underlying>(std::forward<Underlying>(stream));
+        }
+    };
+    inline constexpr DecompressedFunctor Decompressed;
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Native.hpp>
+
+namespace myakish::streams
+{
+    namespace detail
+    {
+        struct AlignedDelete
+        {
+            Size alignment;
+
+            void operator()(std::byte* data) const
+            {
+                ::operator delete[](data, std::align_val_t(alignment));
+            }
+        };
+
+        using AlignedBuffer = std::unique_ptr<std::byte[], AlignedDelete>;
+
+        inline AlignedBuffer AllocateAligned(Size size, Size alignment)
+        {
+            return AlignedBuffer(static_cast<std::byte*>(::operator new[](size, std::align_val_t(alignment))), AlignedDelete{ alignment });
+        }
+
+        // Filesystems without unbuffered I/O (tmpfs, some network mounts) refuse the flag; the streams stay block-aligned either way
+        inline NativeFile OpenDirect(const fs::path& path, FileMode mode)
+        {
+            NativeFile file(path, mode | FileMode::Direct);
+            if (!file.Valid()) file = NativeFile(path, mode);
+
+            return file;
+        }
+    }
+
+    // Bypasses the page cache: only whole blocks from a block-aligned buffer reach the file.
+    // The last partial block is zero-padded on Close and the file is truncated back to Offset()
+    struct DirectFileOutputStream
+    {
+        inline constexpr static Size DefaultCapacity = 1 << 22;
+
+        NativeFile file;
+        Size block;
+        Size capacity;
+        detail::AlignedBuffer buffer;
+        Size used;
+        Size position;
+        bool valid;
+
+        DirectFileOutputStream(const fs::path& path, Size capacity = DefaultCapacity) :
+            file(detail::OpenDirect(path, FileMode::Overwrite)), block(NativeFile::PageSize()), capacity(std::max(capacity + Padding(capacity, block), block)),
+            buffer(detail::AllocateAligned(this->capacity, block)), used(0), position(0), valid(file.Valid()) {}
+
+        DirectFileOutputStream(DirectFileOutputStream&& rhs) noexcept = default;
+        DirectFileOutputStream(const DirectFileOutputStream&) = delete;
+
+        ~DirectFileOutputStream()
+        {
+            Close();
+        }
+
+        void Write(const std::byte* source, Size size)
+        {
+            while (size > 0)
+            {
+                auto count = std::min(size, capacity - used);
+
+                std::memcpy(buffer.get() + used, source, count);
+                used += count;
+
+                if (used == capacity) Flush();
+
+                source += count;
+                size -= count;
+            }
+        }
+
+        std::byte* Write(Size size)
+        {
+            auto region = Acquire(size);
+            Commit(size);
+
+            return region.data();
+        }
+
+        std::span<std::byte> Acquire(Size size)
+        {
+            if (used + size > capacity) Flush();
+            if (used + size > capacity) Grow(used + size);
+
+            return { buffer.get() + used, static_cast<std::size_t>(size) };
+        }
+
+        void Commit(Size size)
+        {
+            used += size;
+        }
+
+        // Skipped bytes still have to be written as part of their blocks
+        void Seek(Size size)
+        {
+            while (size > 0)
+            {
+                auto count = std::min(size, capacity - used);
+
+                std::memset(buffer.get() + used, 0, count);
+                used += count;
+
+                if (used == capacity) Flush();
+
+                size -= count;
+            }
+        }
+
+        Size Offset() const
+        {
+            return position + used;
+        }
+
+        Size BlockSize() const
+        {
+            return block;
+        }
+
+        // Writes out every complete block; the partial tail stays buffered
+        void Flush()
+        {
+            auto complete = used - used % block;
+            if (!complete) return;
+
+            valid &= file.WriteAt(buffer.get(), complete, position) == complete;
+            position += complete;
+
+            std::memmove(buffer.get(), buffer.get() + complete, used - complete);
+            used -= complete;
+        }
+
+        void Close()
+        {
+            if (!file.Valid()) return;
+
+            auto end = Offset();
+
+            Seek(Padding(end, block));
+            Flush();
+
+            valid &= file.Truncate(end);
+            file.Close();
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+    private:
+
+        void Grow(Size required)
+        {
+            auto grown = required + Padding(required, block);
+            auto replacement = detail::AllocateAligned(grown, block);
+
+            std::memcpy(replacement.get(), buffer.get(), used);
+
+            buffer = std::move(replacement);
+            capacity = grown;
+        }
+    };
+    static_assert(PointerOutputStream<DirectFileOutputStream>, "DirectFileOutputStream must be PointerOutputStream");
+    static_assert(TransactionalStream<DirectFileOutputStream>, "DirectFileOutputStream must be TransactionalStream");
+    static_assert(AlignableStream<DirectFileOutputStream>, "DirectFileOutputStream must be AlignableStream");
+
+    // Reads whole blocks at block-aligned offsets into an aligned buffer; base is the file offset of its first byte
+    struct DirectFileInputStream
+    {
+        inline constexpr static Size DefaultCapacity = 1 << 22;
+
+        NativeFile file;
+        Size block;
+        Size capacity;
+        detail::AlignedBuffer buffer;
+        Size base;
+        Size cursor;
+        Size filled;
+        Size length;
+        bool valid;
+
+        DirectFileInputStream(const fs::path& path, Size capacity = DefaultCapacity) :
+            file(detail::OpenDirect(path, FileMode::ReadOnly)), block(NativeFile::PageSize()), capacity(std::max(capacity + Padding(capacity, block), 2 * block)),
+            buffer(detail::AllocateAligned(this->capacity, block)), base(0), cursor(0), filled(0), length(file.Length()), valid(file.Valid()) {}
+
+        DirectFileInputStream(DirectFileInputStream&& rhs) noexcept = default;
+        DirectFileInputStream(const DirectFileInputStream&) = delete;
+
+        void Read(std::byte* destination, Size size)
+        {
+            while (size > 0)
+            {
+                if (cursor >= filled) Refill(std::min(size, capacity - block));
+
+                auto count = std::min(size, filled - cursor);
+
+                std::memcpy(destination, buffer.get() + cursor, count);
+                cursor += count;
+
+                destination += count;
+                size -= count;
+            }
+        }
+
+        const std::byte* Read(Size size)
+        {
+            if (filled - cursor < size) Refill(size);
+
+            return buffer.get() + std::exchange(cursor, cursor + size);
+        }
+
+        void Seek(Size size)
+        {
+            if (size <= filled - cursor)
+            {
+                cursor += size;
+                return;
+            }
+
+            auto target = Offset() + size;
+
+            base = target - target % block;
+            cursor = target - base;
+            filled = 0;
+        }
+
+        Size Offset() const
+        {
+            return base + cursor;
+        }
+
+        Size Length() const
+        {
+            return length - Offset();
+        }
+
+        Size BlockSize() const
+        {
+            return block;
+        }
+
+        bool Valid() const
+        {
+            return valid && Offset() <= length;
+        }
+
+    private:
+
+        // Re-reads from the block containing the cursor; at most one block is fetched twice.
+        // A short file zero-fills the missing part of the request and invalidates the stream
+        void Refill(Size required)
+        {
+            auto target = Offset();
+            auto aligned = target - target % block;
+            auto skipped = target - aligned;
+
+            if (skipped + required > capacity)
+            {
+                capacity = skipped + required + Padding(skipped + required, block);
+                buffer = detail::AllocateAligned(capacity, block);
+            }
+
+            base = aligned;
+            cursor = skipped;
+            filled = std::max(file.ReadAt(buffer.get(), capacity, base), skipped);
+
+            if (filled - cursor >= required) return;
+
+            std::memset(buffer.get() + filled, 0, cursor + required - filled);
+            filled = cursor + required;
+
+            valid = false;
+        }
+    };
+    static_assert(PointerInputStream<DirectFileInputStream>, "DirectFileInputStream must be PointerInputStream");
+    static_assert(SizedStream<DirectFileInputStream>, "DirectFileInputStream must be SizedStream");
+    static_assert(AlignableStream<DirectFileInputStream>, "DirectFileInputStream must be AlignableStream");
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MYAKISH_BYTESWAP_SSSE3
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace myakish::streams
+{
+    template<typename Type>
+    concept SwappableValue = (std::is_arithmetic_v<Type> || std::is_enum_v<Type>) && (sizeof(Type) == 1 || sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8);
+
+    namespace detail
+    {
+        template<std::size_t Width>
+        using SwapWord = std::conditional_t<Width == 2, std::uint16_t, std::conditional_t<Width == 4, std::uint32_t, std::uint64_t>>;
+
+        template<std::size_t Width>
+        void ByteSwapScalar(std::byte* data, Size count)
+        {
+            for (Size i = 0; i < count; i++, data += Width)
+            {
+                SwapWord<Width> word;
+                std::memcpy(&word, data, Width);
+
+                word = std::byteswap(word);
+                std::memcpy(data, &word, Width);
+            }
+        }
+
+#ifdef MYAKISH_BYTESWAP_SSSE3
+        inline bool HasSsse3()
+        {
+            static const bool supported = []
+                {
+#ifdef _MSC_VER
+                    int info[4];
+                    __cpuid(info, 1);
+                    return ((info[2] >> 9) & 1) != 0;
+#else
+                    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+                }();
+
+            return supported;
+        }
+
+        template<std::size_t Width>
+        inline constexpr auto SwapShuffle = []
+            {
+                std::array<std::uint8_t, 16> mask{};
+                for (std::size_t i = 0; i < 16; i++) mask[i] = static_cast<std::uint8_t>(i / Width * Width + (Width - 1 - i % Width));
+                return mask;
+            }();
+
+        template<std::size_t Width>
+#ifndef _MSC_VER
+        __attribute__((target("ssse3")))
+#endif
+        void ByteSwapSsse3(std::byte* data, Size count)
+        {
+            constexpr Size PerVector = 16 / Width;
+
+            auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(SwapShuffle<Width>.data()));
+
+            for (; count >= PerVector; count -= PerVector, data += 16)
+            {
+                auto vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_shuffle_epi8(vector, shuffle));
+            }
+
+            ByteSwapScalar<Width>(data, count);
+        }
+#endif
+
+        template<std::size_t Width>
+        void ByteSwap(std::byte* data, Size count)
+        {
+            if constexpr (Width == 1) return;
+            else
+            {
+#ifdef MYAKISH_BYTESWAP_SSSE3
+                if (HasSsse3())
+                {
+                    ByteSwapSsse3<Width>(data, count);
+                    return;
+                }
+#endif
+                ByteSwapScalar<Width>(data, count);
+            }
+        }
+    }
+
+    // Integers, floats and enums are stored in Order; everything else passes through as raw bytes
+    template<Stream Underlying, std::endian Order>
+    class EndianStream
+    {
+    public:
+
+        inline constexpr static bool Swapped = Order != std::endian::native;
+
+        EndianStream(Underlying stream) : stream(std::forward<Underlying>(stream)) {}
+
+        template<SwappableValue Type>
+        Type ReadValue() requires InputStream<Underlying>
+        {
+            Type value;
+            ReadArray(&value, 1);
+            return value;
+        }
+
+        template<SwappableValue Type>
+        void WriteValue(Type value) requires OutputStream<Underlying>
+        {
+            if constexpr (Swapped) detail::ByteSwap<sizeof(Type)>(reinterpret_cast<std::byte*>(&value), 1);
+            streams::Write(stream, reinterpret_cast<const std::byte*>(&value), sizeof(Type));
+        }
+
+        template<SwappableValue Type>
+        void ReadArray(Type* values, Size count) requires InputStream<Underlying>
+        {
+            streams::Read(stream, reinterpret_cast<std::byte*>(values), count * static_cast<Size>(sizeof(Type)));
+            if constexpr (Swapped) detail::ByteSwap<sizeof(Type)>(reinterpret_cast<std::byte*>(values), count);
+        }
+
+        // Swaps in the destination when the underlying stream hands out memory, through a bounded buffer otherwise
+        template<SwappableValue Type>
+        void WriteArray(const Type* values, Size count) requires OutputStream<Underlying>
+        {
+            constexpr Size Width = sizeof(Type);
+
+            if constexpr (!Swapped) streams::Write(stream, reinterpret_cast<const std::byte*>(values), count * Width);
+            else if constexpr (PointerOutputStream<Underlying>)
+            {
+                auto destination = streams::Write(stream, count * Width);
+
+                std::memcpy(destination, values, count * Width);
+                detail::ByteSwap<Width>(destination, count);
+            }
+            else
+            {
+                constexpr Size Batch = 4096 / Width;
+                alignas(16) std::byte buffer[Batch * Width];
+
+                for (Size done = 0; done < count; done += Batch)
+                {
+                    auto batch = std::min(Batch, count - done);
+
+                    std::memcpy(buffer, values + done, batch * Width);
+                    detail::ByteSwap<Width>(buffer, batch);
+
+                    streams::Write(stream, buffer, batch * Width);
+                }
+            }
+        }
+
+        void Read(std::byte* dst, Size size) requires InputStream<Underlying>
+        {
+            streams::Read(stream, dst, size);
+        }
+
+        const std::byte* Read(Size size) requires PointerInputStream<Underlying>
+        {
+            return streams::Read(stream, size);
+        }
+
+        void Write(const std::byte* src, Size size) requires OutputStream<Underlying>
+        {
+            streams::Write(stream, src, size);
+        }
+
+        std::byte* Write(Size size) requires PointerOutputStream<Underlying>
+        {
+            return streams::Write(stream, size);
+        }
+
+        void Seek(Size size)
+        {
+            streams::Seek(stream, size);
+        }
+
+        Size Offset() const requires AlignableStream<Underlying>
+        {
+            return streams::Offset(stream);
+        }
+
+        Size Length() const requires SizedStream<Underlying>
+        {
+            return streams::Length(stream);
+        }
+
+        void Reserve(Size size) requires ReservableStream<Underlying>
+        {
+            streams::Reserve(stream, size);
+        }
+
+        bool Valid() const requires requires(const Underlying& stream) { stream.Valid(); }
+        {
+            return stream.Valid();
+        }
+
+    private:
+
+        Underlying stream;
+    };
+
+    template<std::endian Order>
+    struct EndianFunctor : functional::ExtensionMethod
+    {
+        template<Stream Underlying>
+        auto operator()(Underlying&& stream) const
+        {
+            return EndianStream<Underlying, Order>(std::forward<Underlying>(stream));
+        }
+    };
+    template<std::endian Order>
+    inline constexpr EndianFunctor<Order> Endian;
+
+    inline constexpr auto BigEndian = Endian<std::endian::big>;
+    inline constexpr auto LittleEndian = Endian<std::endian::little>;
+
+    static_assert(PointerInputStream<EndianStream<PointerInputStreamArchetype, std::endian::big>>, "EndianStream must be PointerInputStream");
+    static_assert(PointerOutputStream<EndianStream<PointerOutputStreamArchetype, std::endian::big>>, "EndianStream must be PointerOutputStream");
+    static_assert(AlignableStream<EndianStream<AlignableStreamArchetype, std::endian::big>>, "EndianStream must be AlignableStream");
+    static_assert(SizedStream<EndianStream<SizedStreamArchetype, std::endian::big>>, "EndianStream must be SizedStream");
+}
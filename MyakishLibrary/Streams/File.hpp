@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Native.hpp>
+
+namespace myakish::streams
+{
+    struct BufferedFileInputStream;
+
+    struct BufferedFileOutputStream
+    {
+        inline constexpr static Size DefaultCapacity = 1 << 20;
+
+        NativeFile file;
+        std::unique_ptr<std::byte[]> buffer;
+        Size capacity;
+        Size used;
+        Size position;
+        bool valid;
+
+        BufferedFileOutputStream(const fs::path& path, Size capacity = DefaultCapacity) :
+            file(path, FileMode::Overwrite), buffer(std::make_unique_for_overwrite<std::byte[]>(capacity)), capacity(capacity), used(0), position(0), valid(file.Valid()) {}
+
+        BufferedFileOutputStream(BufferedFileOutputStream&& rhs) noexcept = default;
+        BufferedFileOutputStream(const BufferedFileOutputStream&) = delete;
+
+        ~BufferedFileOutputStream()
+        {
+            Close();
+        }
+
+        void Write(const std::byte* source, Size size)
+        {
+            if (used + size > capacity) Flush();
+
+            if (size >= capacity)
+            {
+                valid &= file.WriteAt(source, size, position) == size;
+                position += size;
+                return;
+            }
+
+            std::memcpy(buffer.get() + used, source, size);
+            used += size;
+        }
+
+        std::byte* Write(Size size)
+        {
+            auto region = Acquire(size);
+            Commit(size);
+
+            return region.data();
+        }
+
+        std::span<std::byte> Acquire(Size size)
+        {
+            if (used + size > capacity) Flush();
+
+            if (size > capacity)
+            {
+                buffer = std::make_unique_for_overwrite<std::byte[]>(size);
+                capacity = size;
+            }
+
+            return { buffer.get() + used, static_cast<std::size_t>(size) };
+        }
+
+        void Commit(Size size)
+        {
+            used += size;
+        }
+
+        void Seek(Size size)
+        {
+            if (used + size <= capacity)
+            {
+                std::memset(buffer.get() + used, 0, size);
+                used += size;
+                return;
+            }
+
+            Flush();
+            position += size;
+        }
+
+        Size Offset() const
+        {
+            return position + used;
+        }
+
+        void CopyFrom(BufferedFileInputStream& in, Size bytes);
+
+        void Flush()
+        {
+            if (!used) return;
+
+            valid &= file.WriteAt(buffer.get(), used, position) == used;
+            position += std::exchange(used, 0);
+        }
+
+        void Close()
+        {
+            if (!file.Valid()) return;
+
+            Flush();
+            if (file.Length() < position) valid &= file.Truncate(position);
+
+            file.Close();
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+    };
+    static_assert(PointerOutputStream<BufferedFileOutputStream>, "BufferedFileOutputStream must be PointerOutputStream");
+    static_assert(TransactionalStream<BufferedFileOutputStream>, "BufferedFileOutputStream must be TransactionalStream");
+    static_assert(AlignableStream<BufferedFileOutputStream>, "BufferedFileOutputStream must be AlignableStream");
+
+    struct BufferedFileInputStream
+    {
+        inline constexpr static Size DefaultCapacity = 1 << 20;
+
+        NativeFile file;
+        std::unique_ptr<std::byte[]> buffer;
+        Size capacity;
+        Size begin;
+        Size cursor;
+        Size filled;
+        Size length;
+        bool valid;
+
+        BufferedFileInputStream(const fs::path& path, Size capacity = DefaultCapacity) :
+            file(path, FileMode::ReadOnly), buffer(std::make_unique_for_overwrite<std::byte[]>(capacity)), capacity(capacity), begin(0), cursor(0), filled(0), length(file.Length()), valid(file.Valid()) {}
+
+        BufferedFileInputStream(BufferedFileInputStream&& rhs) noexcept = default;
+        BufferedFileInputStream(const BufferedFileInputStream&) = delete;
+
+        void Read(std::byte* destination, Size size)
+        {
+            auto buffered = std::min(size, filled - cursor);
+
+            std::memcpy(destination, buffer.get() + cursor, buffered);
+            cursor += buffered;
+
+            if (buffered == size) return;
+
+            destination += buffered;
+            size -= buffered;
+
+            if (size >= capacity)
+            {
+                auto offset = Offset();
+                valid &= file.ReadAt(destination, size, offset) == size;
+
+                begin = offset + size;
+                cursor = filled = 0;
+                return;
+            }
+
+            Refill(size);
+
+            std::memcpy(destination, buffer.get() + cursor, size);
+            cursor += size;
+        }
+
+        const std::byte* Read(Size size)
+        {
+            if (filled - cursor < size) Refill(size);
+
+            return buffer.get() + std::exchange(cursor, cursor + size);
+        }
+
+        void Seek(Size size)
+        {
+            if (size <= filled - cursor)
+            {
+                cursor += size;
+                return;
+            }
+
+            begin = Offset() + size;
+            cursor = filled = 0;
+        }
+
+        Size Offset() const
+        {
+            return begin + cursor;
+        }
+
+        Size Length() const
+        {
+            return length - Offset();
+        }
+
+        bool Valid() const
+        {
+            return valid && Offset() <= length;
+        }
+
+    private:
+
+        void Refill(Size required)
+        {
+            auto remaining = filled - cursor;
+
+            if (required > capacity)
+            {
+                auto grown = std::make_unique_for_overwrite<std::byte[]>(required);
+                std::memcpy(grown.get(), buffer.get() + cursor, remaining);
+
+                buffer = std::move(grown);
+                capacity = required;
+            }
+            else std::memmove(buffer.get(), buffer.get() + cursor, remaining);
+
+            begin += cursor;
+            cursor = 0;
+
+            auto fetched = file.ReadAt(buffer.get() + remaining, capacity - remaining, begin + remaining);
+            filled = remaining + fetched;
+
+            valid &= filled >= required;
+        }
+    };
+    static_assert(PointerInputStream<BufferedFileInputStream>, "BufferedFileInputStream must be PointerInputStream");
+    static_assert(SizedStream<BufferedFileInputStream>, "BufferedFileInputStream must be SizedStream");
+    static_assert(AlignableStream<BufferedFileInputStream>, "BufferedFileInputStream must be AlignableStream");
+
+    inline void BufferedFileOutputStream::CopyFrom(BufferedFileInputStream& in, Size bytes)
+    {
+        auto buffered = std::min(bytes, in.filled - in.cursor);
+
+        Write(in.Read(buffered), buffered);
+        bytes -= buffered;
+
+        if (bytes == 0) return;
+
+        Flush();
+
+        auto copied = NativeFile::CopyRange(in.file, in.Offset(), file, position, bytes);
+        valid &= copied == bytes;
+        in.valid &= copied == bytes;
+
+        position += bytes;
+        in.Seek(bytes);
+    }
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+namespace myakish::streams
+{
+    // Reading past the limit zero-fills and invalidates instead of touching the underlying stream.
+    // Offset is the underlying stream's when it is AlignableStream, so alignment inside the slice matches the parent
+    template<InputStream Underlying>
+    class LimitedStream
+    {
+    public:
+
+        LimitedStream(Underlying stream, Size limit, bool valid = true) : stream(std::forward<Underlying>(stream)), limit(limit), remaining(limit), valid(valid) {}
+
+        void Read(std::byte* dst, Size size)
+        {
+            if (size > remaining)
+            {
+                std::memset(dst + remaining, 0, size - remaining);
+
+                size = remaining;
+                valid = false;
+            }
+
+            streams::Read(stream, dst, size);
+            remaining -= size;
+        }
+
+        template<typename Type>
+        Type ReadValue() requires requires(Underlying& stream, Type* values, Size count) { stream.ReadArray(values, count); }
+        {
+            Type value;
+            ReadArray(&value, 1);
+            return value;
+        }
+
+        // Whole values that fit go through the layer below; the rest are zero-filled and a partial one is skipped
+        template<typename Type>
+        void ReadArray(Type* values, Size count) requires requires(Underlying& stream) { stream.ReadArray(values, count); }
+        {
+            constexpr Size Width = sizeof(Type);
+
+            auto fitting = std::min(count, remaining / Width);
+
+            stream.ReadArray(values, fitting);
+            remaining -= fitting * Width;
+
+            if (fitting == count) return;
+
+            std::memset(values + fitting, 0, (count - fitting) * Width);
+            streams::Seek(stream, std::exchange(remaining, 0));
+            valid = false;
+        }
+
+        const std::byte* Read(Size size) requires PointerInputStream<Underlying>
+        {
+            if (size <= remaining)
+            {
+                remaining -= size;
+                return streams::Read(stream, size);
+            }
+
+            if (static_cast<Size>(scratch.size()) < size) scratch.resize(size);
+
+            auto available = std::exchange(remaining, 0);
+
+            if (available) std::memcpy(scratch.data(), streams::Read(stream, available), available);
+            std::memset(scratch.data() + available, 0, size - available);
+
+            valid = false;
+            return scratch.data();
+        }
+
+        void Seek(Size size)
+        {
+            if (size > remaining)
+            {
+                size = remaining;
+                valid = false;
+            }
+
+            streams::Seek(stream, size);
+            remaining -= size;
+        }
+
+        void SkipRemaining()
+        {
+            streams::Seek(stream, std::exchange(remaining, 0));
+        }
+
+        Size Offset() const
+        {
+            if constexpr (AlignableStream<Underlying>) return streams::Offset(stream);
+            else return limit - remaining;
+        }
+
+        Size Length() const
+        {
+            return remaining;
+        }
+
+        auto Data() const requires PersistentDataStream<Underlying>
+        {
+            return streams::Data(stream);
+        }
+
+        bool Valid() const
+        {
+            if constexpr (requires(const Underlying& stream) { stream.Valid(); }) return valid && stream.Valid();
+            else return valid;
+        }
+
+    private:
+
+        Underlying stream;
+        Size limit;
+        Size remaining;
+        bool valid;
+
+        std::vector<std::byte> scratch;
+    };
+    static_assert(SizedStream<LimitedStream<InputStreamArchetype>>, "LimitedStream must be SizedStream");
+    static_assert(AlignableStream<LimitedStream<InputStreamArchetype>>, "LimitedStream must be AlignableStream");
+    static_assert(PointerInputStream<LimitedStream<PointerInputStreamArchetype>>, "LimitedStream must be PointerInputStream");
+    static_assert(PersistentDataStream<LimitedStream<ContiguousStream<true>>>, "LimitedStream must be PersistentDataStream");
+
+    // Over sized pointer streams that pass bytes through unchanged the parent is advanced past the sub-stream at once and a slice is returned.
+    // A limit beyond the parent's end is cut to what is left and the slice starts out invalid.
+    // The slice lives as long as the parent's pointers do: until its next operation unless it is a PersistentDataStream
+    struct LimitFunctor : functional::ExtensionMethod
+    {
+        template<InputStream Underlying>
+        auto operator()(Underlying&& stream, Size limit) const
+        {
+            if constexpr (PointerInputStream<Underlying> && SizedStream<Underlying> && !ValueStream<Underlying>)
+            {
+                auto count = std::clamp(limit, Size(0), streams::Length(stream));
+                return LimitedStream<ContiguousStream<true>>(ContiguousStream<true>(streams::Read(stream, count), count), count, count == limit);
+            }
+            else return LimitedStream<Underlying>(std::forward<Underlying>(stream), limit);
+        }
+    };
+    inline constexpr LimitFunctor Limit;
+
+    struct SkipRemainingFunctor : functional::ExtensionMethod
+    {
+        template<Stream Type> requires (SizedStream<Type> || requires(Type& stream) { stream.SkipRemaining(); })
+        void operator()(Type&& stream) const
+        {
+            if constexpr (requires { stream.SkipRemaining(); }) stream.SkipRemaining();
+            else streams::Seek(stream, streams::Length(stream));
+        }
+    };
+    inline constexpr SkipRemainingFunctor SkipRemaining;
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Native.hpp>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace myakish::streams
+{
+    enum class AccessHint
+    {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed
+    };
+
+    namespace detail
+    {
+        struct MappedRegion
+        {
+            std::byte* data = nullptr;
+            Size length = 0;
+#ifdef _WIN32
+            HANDLE mapping = nullptr;
+#endif
+
+            MappedRegion() = default;
+
+            MappedRegion(NativeFile& file, Size length, bool writable) : length(length)
+            {
+                if (!file.Valid() || length == 0) return;
+#ifdef _WIN32
+                mapping = CreateFileMappingW(file.NativeHandle(), nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                    static_cast<DWORD>(length >> 32), static_cast<DWORD>(length), nullptr);
+                if (!mapping) return;
+
+                data = static_cast<std::byte*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length));
+#else
+                auto mapped = ::mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.NativeHandle(), 0);
+                if (mapped != MAP_FAILED) data = static_cast<std::byte*>(mapped);
+#endif
+            }
+
+            MappedRegion(MappedRegion&& rhs) noexcept :
+                data(std::exchange(rhs.data, nullptr)), length(std::exchange(rhs.length, 0))
+#ifdef _WIN32
+                , mapping(std::exchange(rhs.mapping, nullptr))
+#endif
+            {}
+            MappedRegion(const MappedRegion&) = delete;
+
+            MappedRegion& operator=(MappedRegion&& rhs) noexcept
+            {
+                std::swap(data, rhs.data);
+                std::swap(length, rhs.length);
+#ifdef _WIN32
+                std::swap(mapping, rhs.mapping);
+#endif
+                return *this;
+            }
+            MappedRegion& operator=(const MappedRegion&) = delete;
+
+            ~MappedRegion()
+            {
+                Unmap();
+            }
+
+            void Unmap()
+            {
+#ifdef _WIN32
+                if (data) UnmapViewOfFile(data);
+                if (mapping) CloseHandle(mapping);
+                mapping = nullptr;
+#else
+                if (data) ::munmap(data, length);
+#endif
+                data = nullptr;
+                length = 0;
+            }
+
+            bool Grow(NativeFile& file, Size capacity)
+            {
+#ifdef __linux__
+                if (data)
+                {
+                    if (!file.Truncate(capacity)) return false;
+
+                    auto remapped = ::mremap(data, length, capacity, MREMAP_MAYMOVE);
+                    if (remapped == MAP_FAILED) return false;
+
+                    data = static_cast<std::byte*>(remapped);
+                    length = capacity;
+                    return true;
+                }
+#endif
+                Unmap();
+#ifndef _WIN32 // CreateFileMapping extends the file by itself
+                if (!file.Truncate(capacity)) return false;
+#endif
+                *this = MappedRegion(file, capacity, true);
+                return data != nullptr;
+            }
+
+            bool Sync(Size offset, Size size)
+            {
+                if (!data || size == 0) return true;
+
+#ifdef _WIN32
+                return FlushViewOfFile(data + offset, size);
+#else
+                auto page = NativeFile::PageSize();
+                auto aligned = offset - offset % page;
+
+                return ::msync(data + aligned, size + (offset - aligned), MS_SYNC) == 0;
+#endif
+            }
+
+            void Advise(AccessHint hint, Size offset, Size size)
+            {
+                if (!data || size == 0) return;
+
+#ifdef _WIN32
+                if (hint != AccessHint::WillNeed && hint != AccessHint::Sequential) return;
+
+                WIN32_MEMORY_RANGE_ENTRY range{ data + offset, static_cast<SIZE_T>(size) };
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+                auto page = NativeFile::PageSize();
+                auto aligned = offset - offset % page;
+
+                int advice = MADV_NORMAL;
+                switch (hint)
+                {
+                case AccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+                case AccessHint::Random: advice = MADV_RANDOM; break;
+                case AccessHint::WillNeed: advice = MADV_WILLNEED; break;
+                default: break;
+                }
+
+                ::madvise(data + aligned, size + (offset - aligned), advice);
+#endif
+            }
+        };
+    }
+
+    class MappedFile
+    {
+        NativeFile file;
+        detail::MappedRegion region;
+
+    public:
+
+        MappedFile() = default;
+
+        MappedFile(const fs::path& path, AccessHint hint = AccessHint::Normal) : file(path, FileMode::ReadOnly), region(file, file.Valid() ? file.Length() : 0, false)
+        {
+            if (hint != AccessHint::Normal) Advise(hint);
+        }
+
+        bool Valid() const
+        {
+            return file.Valid() && (region.data || region.length == 0);
+        }
+
+        const std::byte* Data() const
+        {
+            return region.data;
+        }
+
+        Size Length() const
+        {
+            return region.length;
+        }
+
+        std::span<const std::byte> Bytes() const
+        {
+            return { region.data, static_cast<std::size_t>(region.length) };
+        }
+
+        void Advise(AccessHint hint)
+        {
+            region.Advise(hint, 0, region.length);
+        }
+
+        void Advise(AccessHint hint, Size offset, Size size)
+        {
+            region.Advise(hint, offset, size);
+        }
+    };
+
+    struct MappedInputStream
+    {
+        MappedFile file;
+        Size cursor;
+
+        MappedInputStream(const fs::path& path, AccessHint hint = AccessHint::Sequential) : file(path, hint), cursor(0) {}
+
+        MappedInputStream(MappedFile file) : file(std::move(file)), cursor(0) {}
+
+        const std::byte* Read(Size size)
+        {
+            return file.Data() + std::exchange(cursor, cursor + size);
+        }
+
+        void Seek(Size size)
+        {
+            cursor += size;
+        }
+
+        Size Offset() const
+        {
+            return cursor;
+        }
+
+        Size Length() const
+        {
+            return file.Length() - cursor;
+        }
+
+        const std::byte* Data() const
+        {
+            return file.Data() + cursor;
+        }
+
+        bool Valid() const
+        {
+            return file.Valid() && cursor <= file.Length();
+        }
+    };
+    static_assert(PointerInputStream<MappedInputStream>, "MappedInputStream must be PointerInputStream");
+    static_assert(SizedStream<MappedInputStream>, "MappedInputStream must be SizedStream");
+    static_assert(AlignableStream<MappedInputStream>, "MappedInputStream must be AlignableStream");
+    static_assert(PersistentDataStream<MappedInputStream>, "MappedInputStream must be PersistentDataStream");
+
+    struct MappedOutputStream
+    {
+        inline constexpr static Size DefaultCapacity = 1 << 20;
+
+        NativeFile file;
+        detail::MappedRegion region;
+        std::vector<std::byte> discard;
+        Size cursor;
+        Size end;
+        bool sync;
+        bool valid;
+
+        MappedOutputStream(const fs::path& path, Size initialCapacity = DefaultCapacity, bool sync = false) :
+            file(path, FileMode::Read | FileMode::Overwrite), cursor(0), end(0), sync(sync), valid(file.Valid())
+        {
+            if (valid) valid = region.Grow(file, std::max<Size>(initialCapacity, NativeFile::PageSize()));
+        }
+
+        MappedOutputStream(MappedOutputStream&& rhs) noexcept = default;
+        MappedOutputStream(const MappedOutputStream&) = delete;
+
+        ~MappedOutputStream()
+        {
+            Close();
+        }
+
+        std::byte* Write(Size size)
+        {
+            if (!Ensure(cursor + size))
+            {
+                if (static_cast<Size>(discard.size()) < size) discard.resize(size);
+                cursor += size;
+                return discard.data();
+            }
+
+            auto at = region.data + cursor;
+            Advance(size);
+            return at;
+        }
+
+        void Write(const std::byte* source, Size size)
+        {
+            std::memcpy(Write(size), source, size);
+        }
+
+        std::span<std::byte> Acquire(Size size)
+        {
+            if (!Ensure(cursor + size))
+            {
+                if (static_cast<Size>(discard.size()) < size) discard.resize(size);
+                return { discard.data(), static_cast<std::size_t>(size) };
+            }
+
+            return { region.data + cursor, static_cast<std::size_t>(size) };
+        }
+
+        void Commit(Size size)
+        {
+            if (valid) Advance(size);
+            else cursor += size;
+        }
+
+        void Seek(Size size)
+        {
+            if (Ensure(cursor + size)) Advance(size);
+            else cursor += size;
+        }
+
+        void Reserve(Size size)
+        {
+            Ensure(cursor + size);
+        }
+
+        Size Offset() const
+        {
+            return cursor;
+        }
+
+        void Close()
+        {
+            if (!file.Valid()) return;
+
+            if (sync) valid &= region.Sync(0, end);
+            region.Unmap();
+
+            valid &= file.Truncate(end);
+            if (sync) valid &= file.Sync();
+
+            file.Close();
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+    private:
+
+        bool Ensure(Size required)
+        {
+            if (required <= region.length) return valid;
+            if (!valid) return false;
+
+            valid = region.Grow(file, std::max(required, 2 * region.length));
+            return valid;
+        }
+
+        void Advance(Size size)
+        {
+            cursor += size;
+            end = std::max(end, cursor);
+        }
+    };
+    static_assert(PointerOutputStream<MappedOutputStream>, "MappedOutputStream must be PointerOutputStream");
+    static_assert(TransactionalStream<MappedOutputStream>, "MappedOutputStream must be TransactionalStream");
+    static_assert(AlignableStream<MappedOutputStream>, "MappedOutputStream must be AlignableStream");
+    static_assert(ReservableStream<MappedOutputStream>, "MappedOutputStream must be ReservableStream");
+}
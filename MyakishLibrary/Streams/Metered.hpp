@@ -0,0 +1,335 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <utility>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MYAKISH_METERED_RDTSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace myakish::streams
+{
+    // Define MYAKISH_DISABLE_STREAM_METRICS to make Metered return the stream it is given
+#ifdef MYAKISH_DISABLE_STREAM_METRICS
+    inline constexpr bool StreamMetricsEnabled = false;
+#else
+    inline constexpr bool StreamMetricsEnabled = true;
+#endif
+
+    enum class StreamOperation
+    {
+        Read,
+        Write,
+        Seek,
+        Reserve,
+
+        Count
+    };
+
+    // Histograms are log2-bucketed: bucket n holds values in [2^(n-1), 2^n)
+    struct OperationMetrics
+    {
+        inline constexpr static std::size_t Buckets = 65;
+
+        Size calls = 0;
+        Size bytes = 0;
+        std::array<Size, Buckets> sizes{};
+        std::array<Size, Buckets> cycles{};
+
+        static std::size_t Bucket(Size value)
+        {
+            return std::bit_width(static_cast<std::uint64_t>(value));
+        }
+
+        void Record(Size size)
+        {
+            calls++;
+            bytes += size;
+            sizes[Bucket(size)]++;
+        }
+
+        void Merge(const OperationMetrics& rhs)
+        {
+            calls += rhs.calls;
+            bytes += rhs.bytes;
+
+            for (std::size_t i = 0; i < Buckets; i++)
+            {
+                sizes[i] += rhs.sizes[i];
+                cycles[i] += rhs.cycles[i];
+            }
+        }
+    };
+
+    struct StreamMetrics
+    {
+        std::array<OperationMetrics, std::to_underlying(StreamOperation::Count)> operations;
+
+        OperationMetrics& operator[](StreamOperation operation)
+        {
+            return operations[std::to_underlying(operation)];
+        }
+
+        const OperationMetrics& operator[](StreamOperation operation) const
+        {
+            return operations[std::to_underlying(operation)];
+        }
+
+        Size Calls() const
+        {
+            Size total = 0;
+            for (const auto& operation : operations) total += operation.calls;
+            return total;
+        }
+
+        void Merge(const StreamMetrics& rhs)
+        {
+            for (std::size_t i = 0; i < operations.size(); i++) operations[i].Merge(rhs.operations[i]);
+        }
+    };
+
+    template<typename Type>
+    concept MetricsSink = requires(Type& sink, const StreamMetrics& metrics)
+    {
+        sink.Publish(metrics);
+    };
+
+    struct DiscardSink
+    {
+        void Publish(const StreamMetrics&) {}
+    };
+
+    // Shared by reference between streams, possibly on different threads
+    class AggregatingSink
+    {
+    public:
+
+        void Publish(const StreamMetrics& metrics)
+        {
+            std::lock_guard lock(mutex);
+            total.Merge(metrics);
+        }
+
+        StreamMetrics Snapshot() const
+        {
+            std::lock_guard lock(mutex);
+            return total;
+        }
+
+    private:
+
+        mutable std::mutex mutex;
+        StreamMetrics total;
+    };
+
+    namespace detail
+    {
+        // TSC ticks where available, steady_clock nanoseconds elsewhere
+        inline std::uint64_t ReadCycles()
+        {
+#ifdef MYAKISH_METERED_RDTSC
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+
+        struct CycleTimer
+        {
+            OperationMetrics& metrics;
+            std::uint64_t start;
+
+            CycleTimer(OperationMetrics& metrics) : metrics(metrics), start(ReadCycles()) {}
+
+            ~CycleTimer()
+            {
+                metrics.cycles[OperationMetrics::Bucket(static_cast<Size>(ReadCycles() - start))]++;
+            }
+        };
+    }
+
+    // Counts calls, bytes and call sizes per operation, plus call latency when Timed.
+    // Metrics go to the sink on Publish and on destruction
+    template<Stream Underlying, MetricsSink Sink = DiscardSink, bool Timed = false>
+    class MeteredStream
+    {
+    public:
+
+        MeteredStream(Underlying stream, Sink sink = {}) : stream(std::forward<Underlying>(stream)), sink(std::forward<Sink>(sink)) {}
+
+        MeteredStream(MeteredStream&& rhs) noexcept :
+            stream(std::forward<Underlying>(rhs.stream)), sink(std::forward<Sink>(rhs.sink)), metrics(std::exchange(rhs.metrics, {})) {}
+
+        MeteredStream(const MeteredStream&) = delete;
+
+        ~MeteredStream()
+        {
+            if (metrics.Calls() > 0) Publish();
+        }
+
+        void Read(std::byte* dst, Size size) requires InputStream<Underlying>
+        {
+            Measure(StreamOperation::Read, size, [&] { streams::Read(stream, dst, size); });
+        }
+
+        const std::byte* Read(Size size) requires PointerInputStream<Underlying>
+        {
+            return Measure(StreamOperation::Read, size, [&] { return streams::Read(stream, size); });
+        }
+
+        void Write(const std::byte* src, Size size) requires OutputStream<Underlying>
+        {
+            Measure(StreamOperation::Write, size, [&] { streams::Write(stream, src, size); });
+        }
+
+        std::byte* Write(Size size) requires PointerOutputStream<Underlying>
+        {
+            return Measure(StreamOperation::Write, size, [&] { return streams::Write(stream, size); });
+        }
+
+        template<typename Type>
+        Type ReadValue() requires requires(Underlying& stream) { { stream.template ReadValue<Type>() } -> std::same_as<Type>; }
+        {
+            return Measure(StreamOperation::Read, sizeof(Type), [&] { return stream.template ReadValue<Type>(); });
+        }
+
+        template<typename Type>
+        void WriteValue(Type value) requires requires(Underlying& stream) { stream.WriteValue(value); }
+        {
+            Measure(StreamOperation::Write, sizeof(Type), [&] { stream.WriteValue(value); });
+        }
+
+        template<typename Type>
+        void ReadArray(Type* values, Size count) requires requires(Underlying& stream) { stream.ReadArray(values, count); }
+        {
+            Measure(StreamOperation::Read, count * static_cast<Size>(sizeof(Type)), [&] { stream.ReadArray(values, count); });
+        }
+
+        template<typename Type>
+        void WriteArray(const Type* values, Size count) requires requires(Underlying& stream) { stream.WriteArray(values, count); }
+        {
+            Measure(StreamOperation::Write, count * static_cast<Size>(sizeof(Type)), [&] { stream.WriteArray(values, count); });
+        }
+
+        // The committed size is what gets recorded as a write
+        std::span<std::byte> Acquire(Size size) requires TransactionalStream<Underlying>
+        {
+            return streams::Acquire(stream, size);
+        }
+
+        void Commit(Size used) requires TransactionalStream<Underlying>
+        {
+            Measure(StreamOperation::Write, used, [&] { streams::Commit(stream, used); });
+        }
+
+        void Seek(Size size)
+        {
+            Measure(StreamOperation::Seek, size, [&] { streams::Seek(stream, size); });
+        }
+
+        void Reserve(Size size) requires ReservableStream<Underlying>
+        {
+            Measure(StreamOperation::Reserve, size, [&] { streams::Reserve(stream, size); });
+        }
+
+        Size Offset() const requires AlignableStream<Underlying>
+        {
+            return streams::Offset(stream);
+        }
+
+        Size Length() const requires SizedStream<Underlying>
+        {
+            return streams::Length(stream);
+        }
+
+        bool Valid() const requires requires(const Underlying& stream) { stream.Valid(); }
+        {
+            return stream.Valid();
+        }
+
+        const StreamMetrics& Metrics() const
+        {
+            return metrics;
+        }
+
+        // Hands the metrics gathered so far to the sink and starts over
+        void Publish()
+        {
+            sink.Publish(std::exchange(metrics, {}));
+        }
+
+        Underlying& Base()
+        {
+            return stream;
+        }
+
+    private:
+
+        Underlying stream;
+        Sink sink;
+        StreamMetrics metrics;
+
+        template<typename Operation>
+        decltype(auto) Measure(StreamOperation operation, Size size, Operation&& perform)
+        {
+            if constexpr (!StreamMetricsEnabled) return perform();
+            else
+            {
+                auto& entry = metrics[operation];
+                entry.Record(size);
+
+                if constexpr (Timed)
+                {
+                    detail::CycleTimer timer(entry);
+                    return perform();
+                }
+                else return perform();
+            }
+        }
+    };
+
+    template<Stream Underlying>
+    MeteredStream(Underlying&&) -> MeteredStream<Underlying>;
+
+    template<Stream Underlying, MetricsSink Sink>
+    MeteredStream(Underlying&&, Sink&&) -> MeteredStream<Underlying, Sink>;
+
+    static_assert(PointerInputStream<MeteredStream<PointerInputStreamArchetype>>, "MeteredStream must be PointerInputStream");
+    static_assert(PointerOutputStream<MeteredStream<PointerOutputStreamArchetype>>, "MeteredStream must be PointerOutputStream");
+    static_assert(TransactionalStream<MeteredStream<TransactionalStreamArchetype>>, "MeteredStream must be TransactionalStream");
+    static_assert(ReservableStream<MeteredStream<ReservableStreamArchetype>>, "MeteredStream must be ReservableStream");
+    static_assert(AlignableStream<MeteredStream<AlignableStreamArchetype>>, "MeteredStream must be AlignableStream");
+    static_assert(SizedStream<MeteredStream<SizedStreamArchetype>>, "MeteredStream must be SizedStream");
+
+    // With metrics disabled the stream itself is returned, so call sites need no conditional compilation
+    template<bool Timed>
+    struct MeteredFunctor : functional::ExtensionMethod
+    {
+        template<Stream Underlying>
+        decltype(auto) operator()(Underlying&& stream) const
+        {
+            return operator()(std::forward<Underlying>(stream), DiscardSink{});
+        }
+
+        template<Stream Underlying, MetricsSink Sink>
+        auto operator()(Underlying&& stream, Sink&& sink) const -> std::conditional_t<StreamMetricsEnabled, MeteredStream<Underlying, Sink, Timed>, Underlying>
+        {
+            if constexpr (StreamMetricsEnabled) return MeteredStream<Underlying, Sink, Timed>(std::forward<Underlying>(stream), std::forward<Sink>(sink));
+            else return std::forward<Underlying>(stream);
+        }
+    };
+    inline constexpr MeteredFunctor<false> Metered;
+    inline constexpr MeteredFunctor<true> TimedMetered;
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include <MyakishLibrary/Core.hpp>
+
+#include <MyakishLibrary/Enum/BitwiseOperators.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace myakish::streams
+{
+    enum class FileMode : unsigned
+    {
+        Read = 1 << 0,
+        Write = 1 << 1,
+        Create = 1 << 2,
+        Truncate = 1 << 3,
+        Direct = 1 << 4,
+
+        ReadOnly = Read,
+        Overwrite = Write | Create | Truncate
+    };
+
+    // Found through ADL, so the generic enum operators stay limited to FileMode
+    inline FileMode operator|(FileMode lhs, FileMode rhs)
+    {
+        return enums::operators::operator|(lhs, rhs);
+    }
+
+    inline FileMode operator&(FileMode lhs, FileMode rhs)
+    {
+        return enums::operators::operator&(lhs, rhs);
+    }
+
+    constexpr bool HasMode(FileMode mode, FileMode flag)
+    {
+        return (std::to_underlying(mode) & std::to_underlying(flag)) == std::to_underlying(flag);
+    }
+
+    class NativeFile
+    {
+    public:
+
+#ifdef _WIN32
+        using Handle = HANDLE;
+#else
+        using Handle = int;
+#endif
+
+    private:
+
+#ifdef _WIN32
+        inline static const Handle InvalidHandle = INVALID_HANDLE_VALUE;
+#else
+        inline constexpr static Handle InvalidHandle = -1;
+#endif
+
+        // ReadFile/WriteFile take DWORD sizes, read/write cap a single transfer near 2 GiB
+        inline constexpr static Size MaxTransfer = Size(1) << 30;
+
+        // Linux IOV_MAX
+        inline constexpr static std::size_t GatherBatch = 1024;
+
+        Handle handle = InvalidHandle;
+
+    public:
+
+        NativeFile() = default;
+
+        NativeFile(const std::filesystem::path& path, FileMode mode)
+        {
+#ifdef _WIN32
+            DWORD access = (HasMode(mode, FileMode::Read) ? GENERIC_READ : 0) | (HasMode(mode, FileMode::Write) ? GENERIC_WRITE : 0);
+
+            DWORD disposition = HasMode(mode, FileMode::Create)
+                ? (HasMode(mode, FileMode::Truncate) ? CREATE_ALWAYS : OPEN_ALWAYS)
+                : (HasMode(mode, FileMode::Truncate) ? TRUNCATE_EXISTING : OPEN_EXISTING);
+
+            DWORD flags = FILE_ATTRIBUTE_NORMAL;
+            if (HasMode(mode, FileMode::Direct)) flags |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
+
+            handle = CreateFileW(path.c_str(), access, FILE_SHARE_READ, nullptr, disposition, flags, nullptr);
+#else
+            int flags = HasMode(mode, FileMode::Read) && HasMode(mode, FileMode::Write) ? O_RDWR : HasMode(mode, FileMode::Write) ? O_WRONLY : O_RDONLY;
+
+            if (HasMode(mode, FileMode::Create)) flags |= O_CREAT;
+            if (HasMode(mode, FileMode::Truncate)) flags |= O_TRUNC;
+#ifdef O_DIRECT
+            if (HasMode(mode, FileMode::Direct)) flags |= O_DIRECT;
+#endif
+            flags |= O_CLOEXEC;
+
+            handle = ::open(path.c_str(), flags, 0666);
+#endif
+        }
+
+        NativeFile(NativeFile&& rhs) noexcept : handle(std::exchange(rhs.handle, InvalidHandle)) {}
+        NativeFile(const NativeFile&) = delete;
+
+        NativeFile& operator=(NativeFile&& rhs) noexcept
+        {
+            std::swap(handle, rhs.handle);
+            return *this;
+        }
+        NativeFile& operator=(const NativeFile&) = delete;
+
+        ~NativeFile()
+        {
+            Close();
+        }
+
+        void Close()
+        {
+            if (!Valid()) return;
+#ifdef _WIN32
+            CloseHandle(std::exchange(handle, InvalidHandle));
+#else
+            ::close(std::exchange(handle, InvalidHandle));
+#endif
+        }
+
+        bool Valid() const
+        {
+            return handle != InvalidHandle;
+        }
+
+        Handle NativeHandle() const
+        {
+            return handle;
+        }
+
+        Size Read(std::byte* dst, Size size)
+        {
+            Size total = 0;
+            while (total < size)
+            {
+                auto chunk = std::min(size - total, MaxTransfer);
+#ifdef _WIN32
+                DWORD done = 0;
+                if (!ReadFile(handle, dst + total, static_cast<DWORD>(chunk), &done, nullptr) || done == 0) break;
+#else
+                auto done = ::read(handle, dst + total, chunk);
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+#endif
+                total += done;
+            }
+            return total;
+        }
+
+        Size Write(const std::byte* src, Size size)
+        {
+            Size total = 0;
+            while (total < size)
+            {
+                auto chunk = std::min(size - total, MaxTransfer);
+#ifdef _WIN32
+                DWORD done = 0;
+                if (!WriteFile(handle, src + total, static_cast<DWORD>(chunk), &done, nullptr) || done == 0) break;
+#else
+                auto done = ::write(handle, src + total, chunk);
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+#endif
+                total += done;
+            }
+            return total;
+        }
+
+        Size WriteGather(std::span<const std::span<const std::byte>> buffers)
+        {
+            Size total = 0;
+#ifdef _WIN32
+            for (auto buffer : buffers)
+            {
+                auto size = static_cast<Size>(buffer.size());
+                auto written = Write(buffer.data(), size);
+
+                total += written;
+                if (written != size) break;
+            }
+#else
+            std::array<iovec, GatherBatch> vectors;
+
+            std::size_t index = 0;
+            std::size_t skip = 0;
+
+            while (index < buffers.size())
+            {
+                std::size_t count = 0;
+                for (auto i = index; i < buffers.size() && count < GatherBatch; i++, count++)
+                {
+                    auto part = i == index ? buffers[i].subspan(skip) : buffers[i];
+                    vectors[count] = { const_cast<std::byte*>(part.data()), part.size() };
+                }
+
+                auto done = ::writev(handle, vectors.data(), static_cast<int>(count));
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+
+                total += done;
+
+                for (std::size_t left = done; left > 0;)
+                {
+                    auto remaining = buffers[index].size() - skip;
+                    if (left < remaining)
+                    {
+                        skip += left;
+                        break;
+                    }
+
+                    left -= remaining;
+                    index++;
+                    skip = 0;
+                }
+            }
+#endif
+            return total;
+        }
+
+        Size ReadAt(std::byte* dst, Size size, Size offset)
+        {
+            Size total = 0;
+            while (total < size)
+            {
+                auto chunk = std::min(size - total, MaxTransfer);
+#ifdef _WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset + total);
+                overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+
+                DWORD done = 0;
+                if (!ReadFile(handle, dst + total, static_cast<DWORD>(chunk), &done, &overlapped) || done == 0) break;
+#else
+                auto done = ::pread(handle, dst + total, chunk, offset + total);
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+#endif
+                total += done;
+            }
+            return total;
+        }
+
+        Size WriteAt(const std::byte* src, Size size, Size offset)
+        {
+            Size total = 0;
+            while (total < size)
+            {
+                auto chunk = std::min(size - total, MaxTransfer);
+#ifdef _WIN32
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset + total);
+                overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+
+                DWORD done = 0;
+                if (!WriteFile(handle, src + total, static_cast<DWORD>(chunk), &done, &overlapped) || done == 0) break;
+#else
+                auto done = ::pwrite(handle, src + total, chunk, offset + total);
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+#endif
+                total += done;
+            }
+            return total;
+        }
+
+        static Size CopyRange(NativeFile& from, Size fromOffset, NativeFile& to, Size toOffset, Size size)
+        {
+            Size total = 0;
+#ifdef __linux__
+            while (total < size)
+            {
+                off_t in = fromOffset + total;
+                off_t out = toOffset + total;
+
+                auto done = ::copy_file_range(from.handle, &in, to.handle, &out, std::min(size - total, MaxTransfer), 0);
+                if (done < 0 && errno == EINTR) continue;
+                if (done <= 0) break;
+
+                total += done;
+            }
+#endif
+            if (total == size) return total;
+
+            constexpr Size Chunk = 1 << 16;
+            auto buffer = std::make_unique_for_overwrite<std::byte[]>(Chunk);
+
+            while (total < size)
+            {
+                auto fetched = from.ReadAt(buffer.get(), std::min(size - total, Chunk), fromOffset + total);
+                if (fetched == 0) break;
+
+                auto written = to.WriteAt(buffer.get(), fetched, toOffset + total);
+                total += written;
+
+                if (written != fetched) break;
+            }
+            return total;
+        }
+
+        Size Length() const
+        {
+#ifdef _WIN32
+            LARGE_INTEGER size{};
+            if (!GetFileSizeEx(handle, &size)) return 0;
+            return size.QuadPart;
+#else
+            struct stat info{};
+            if (::fstat(handle, &info) != 0) return 0;
+            return info.st_size;
+#endif
+        }
+
+        bool Truncate(Size size)
+        {
+#ifdef _WIN32
+            FILE_END_OF_FILE_INFO info{};
+            info.EndOfFile.QuadPart = size;
+            return SetFileInformationByHandle(handle, FileEndOfFileInfo, &info, sizeof(info));
+#else
+            return ::ftruncate(handle, size) == 0;
+#endif
+        }
+
+        bool Sync()
+        {
+#ifdef _WIN32
+            return FlushFileBuffers(handle);
+#else
+            return ::fsync(handle) == 0;
+#endif
+        }
+
+        static Size PageSize()
+        {
+#ifdef _WIN32
+            SYSTEM_INFO info{};
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return ::sysconf(_SC_PAGESIZE);
+#endif
+        }
+    };
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+namespace myakish::streams
+{
+    // Bounded single-producer/single-consumer ring. Positions grow monotonically, the top bit marks the closing side
+    class PipeStream
+    {
+    public:
+
+        inline constexpr static Size DefaultCapacity = 1 << 20;
+
+        explicit PipeStream(Size capacity = DefaultCapacity) :
+            capacity(static_cast<Size>(std::bit_ceil(static_cast<std::uint64_t>(capacity)))), buffer(std::make_unique_for_overwrite<std::byte[]>(this->capacity)) {}
+
+        PipeStream(const PipeStream&) = delete;
+
+        Size Capacity() const
+        {
+            return capacity;
+        }
+
+    private:
+
+        friend class PipeOutputStream;
+        friend class PipeInputStream;
+
+        inline constexpr static Size ClosedBit = Size(1) << 62;
+
+        Size capacity;
+        std::unique_ptr<std::byte[]> buffer;
+
+        alignas(CacheLineSize) std::atomic<Size> head = 0;
+        alignas(CacheLineSize) std::atomic<Size> tail = 0;
+    };
+
+    class PipeOutputStream
+    {
+        std::shared_ptr<PipeStream> pipe;
+        Size head;
+        Size limit;
+        bool valid;
+
+    public:
+
+        explicit PipeOutputStream(std::shared_ptr<PipeStream> pipe) : pipe(std::move(pipe)), head(0), limit(0), valid(true) {}
+
+        PipeOutputStream(PipeOutputStream&& rhs) noexcept = default;
+        PipeOutputStream(const PipeOutputStream&) = delete;
+
+        ~PipeOutputStream()
+        {
+            Close();
+        }
+
+        // Contiguous free region, empty once the reader is gone. Named apart from Acquire/Commit,
+        // which promise a region of the requested size that a ring cannot give across its wrap point
+        std::span<std::byte> Claim()
+        {
+            if (head == limit)
+            {
+                while (true)
+                {
+                    auto tail = pipe->tail.load(std::memory_order_acquire);
+
+                    if (tail & PipeStream::ClosedBit)
+                    {
+                        valid = false;
+                        return {};
+                    }
+
+                    limit = tail + pipe->capacity;
+                    if (head < limit) break;
+
+                    pipe->tail.wait(tail, std::memory_order_relaxed);
+                }
+            }
+
+            auto at = head & (pipe->capacity - 1);
+            auto count = std::min(limit - head, pipe->capacity - at);
+
+            return { pipe->buffer.get() + at, static_cast<std::size_t>(count) };
+        }
+
+        void Publish(Size count)
+        {
+            head += count;
+
+            pipe->head.store(head, std::memory_order_release);
+            pipe->head.notify_one();
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            while (size > 0)
+            {
+                auto region = Claim();
+                if (region.empty()) return;
+
+                auto count = std::min(size, static_cast<Size>(region.size()));
+                std::memcpy(region.data(), src, count);
+                Publish(count);
+
+                src += count;
+                size -= count;
+            }
+        }
+
+        void Seek(Size size)
+        {
+            while (size > 0)
+            {
+                auto region = Claim();
+                if (region.empty()) return;
+
+                auto count = std::min(size, static_cast<Size>(region.size()));
+                std::memset(region.data(), 0, count);
+                Publish(count);
+
+                size -= count;
+            }
+        }
+
+        Size Offset() const
+        {
+            return head;
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+        void Close()
+        {
+            if (!pipe) return;
+
+            pipe->head.store(head | PipeStream::ClosedBit, std::memory_order_release);
+            pipe->head.notify_all();
+
+            pipe.reset();
+        }
+    };
+    static_assert(OutputStream<PipeOutputStream>, "PipeOutputStream must be OutputStream");
+    static_assert(AlignableStream<PipeOutputStream>, "PipeOutputStream must be AlignableStream");
+
+    class PipeInputStream
+    {
+        std::shared_ptr<PipeStream> pipe;
+        Size tail;
+        Size limit;
+        bool valid;
+
+    public:
+
+        explicit PipeInputStream(std::shared_ptr<PipeStream> pipe) : pipe(std::move(pipe)), tail(0), limit(0), valid(true) {}
+
+        PipeInputStream(PipeInputStream&& rhs) noexcept = default;
+        PipeInputStream(const PipeInputStream&) = delete;
+
+        ~PipeInputStream()
+        {
+            Close();
+        }
+
+        // Contiguous readable region, empty once the writer is closed and drained
+        std::span<const std::byte> Peek()
+        {
+            if (tail == limit)
+            {
+                while (true)
+                {
+                    auto head = pipe->head.load(std::memory_order_acquire);
+
+                    limit = head & ~PipeStream::ClosedBit;
+                    if (tail < limit) break;
+
+                    if (head & PipeStream::ClosedBit) return {};
+
+                    pipe->head.wait(head, std::memory_order_relaxed);
+                }
+            }
+
+            auto at = tail & (pipe->capacity - 1);
+            auto count = std::min(limit - tail, pipe->capacity - at);
+
+            return { pipe->buffer.get() + at, static_cast<std::size_t>(count) };
+        }
+
+        void Consume(Size count)
+        {
+            tail += count;
+
+            pipe->tail.store(tail, std::memory_order_release);
+            pipe->tail.notify_one();
+        }
+
+        void Read(std::byte* dst, Size size)
+        {
+            while (size > 0)
+            {
+                auto region = Peek();
+                if (region.empty())
+                {
+                    valid = false;
+                    return;
+                }
+
+                auto count = std::min(size, static_cast<Size>(region.size()));
+                std::memcpy(dst, region.data(), count);
+                Consume(count);
+
+                dst += count;
+                size -= count;
+            }
+        }
+
+        void Seek(Size size)
+        {
+            while (size > 0)
+            {
+                auto region = Peek();
+                if (region.empty())
+                {
+                    valid = false;
+                    return;
+                }
+
+                auto count = std::min(size, static_cast<Size>(region.size()));
+                Consume(count);
+
+                size -= count;
+            }
+        }
+
+        Size Offset() const
+        {
+            return tail;
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+        void Close()
+        {
+            if (!pipe) return;
+
+            pipe->tail.store(tail | PipeStream::ClosedBit, std::memory_order_release);
+            pipe->tail.notify_all();
+
+            pipe.reset();
+        }
+    };
+    static_assert(InputStream<PipeInputStream>, "PipeInputStream must be InputStream");
+    static_assert(AlignableStream<PipeInputStream>, "PipeInputStream must be AlignableStream");
+
+    struct PipeFunctor : functional::ExtensionMethod
+    {
+        std::pair<PipeOutputStream, PipeInputStream> operator()(Size capacity = PipeStream::DefaultCapacity) const
+        {
+            auto pipe = std::make_shared<PipeStream>(capacity);
+
+            return { PipeOutputStream(pipe), PipeInputStream(pipe) };
+        }
+    };
+    inline constexpr PipeFunctor Pipe;
+}
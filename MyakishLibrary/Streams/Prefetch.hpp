@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+
+namespace myakish::streams
+{
+    // Underlying is only touched by the prefetch thread while a fill is in flight.
+    // Without SizedStream the end of data is unknown: a short fill stops prefetching and Valid turns false once the consumer reads past it.
+    // The data in a short fill is measured with Offset when Underlying is AlignableStream, otherwise the whole fill counts
+    template<InputStream Underlying>
+    class PrefetchingInputStream
+    {
+    public:
+
+        inline constexpr static Size DefaultCapacity = 1 << 20;
+
+        PrefetchingInputStream(Underlying stream, Size capacity = DefaultCapacity) :
+            stream(std::forward<Underlying>(stream)), capacity(capacity),
+            front(std::make_unique_for_overwrite<std::byte[]>(capacity)), back(std::make_unique_for_overwrite<std::byte[]>(capacity))
+        {
+            if constexpr (SizedStream<Underlying>) unrequested = length = streams::Length(this->stream);
+            if constexpr (AlignableStream<Underlying>) base = streams::Offset(this->stream);
+
+            worker = std::jthread([this](std::stop_token stop) { Work(stop); });
+            Schedule();
+        }
+
+        PrefetchingInputStream(const PrefetchingInputStream&) = delete;
+
+        void Read(std::byte* dst, Size size)
+        {
+            while (size > 0)
+            {
+                if (cursor == frontSize && !Swap())
+                {
+                    valid = false;
+                    return;
+                }
+
+                auto count = std::min(size, frontSize - cursor);
+                std::memcpy(dst, front.get() + cursor, count);
+
+                dst += count;
+                cursor += count;
+                consumed += count;
+                size -= count;
+            }
+        }
+
+        const std::byte* Read(Size size)
+        {
+            if (frontSize - cursor >= size)
+            {
+                consumed += size;
+                return front.get() + std::exchange(cursor, cursor + size);
+            }
+
+            if (static_cast<Size>(scratch.size()) < size) scratch.resize(size);
+            Read(scratch.data(), size);
+
+            return scratch.data();
+        }
+
+        void Seek(Size size)
+        {
+            consumed += size;
+
+            auto available = frontSize - cursor;
+            if (size <= available)
+            {
+                cursor += size;
+                return;
+            }
+
+            size -= available;
+            cursor = frontSize;
+
+            Wait();
+            if (size <= backFetched)
+            {
+                Swap();
+                cursor = size;
+                return;
+            }
+
+            if (!backValid)
+            {
+                consumed -= size - backFetched;
+
+                Swap();
+                cursor = frontSize;
+                valid = false;
+                return;
+            }
+
+            size -= backSize;
+            frontSize = cursor = backSize = backFetched = 0;
+
+            // Past the end only what is left is skipped, so Length() never goes negative
+            if constexpr (SizedStream<Underlying>)
+            {
+                if (size > unrequested)
+                {
+                    consumed -= size - unrequested;
+                    size = unrequested;
+                    valid = false;
+                }
+                unrequested -= size;
+            }
+
+            streams::Seek(stream, size);
+
+            Schedule();
+        }
+
+        Size Offset() const requires AlignableStream<Underlying>
+        {
+            return base + consumed;
+        }
+
+        Size Length() const requires SizedStream<Underlying>
+        {
+            return length - consumed;
+        }
+
+        bool Valid() const
+        {
+            return valid;
+        }
+
+    private:
+
+        Underlying stream;
+        Size capacity;
+
+        std::unique_ptr<std::byte[]> front;
+        std::unique_ptr<std::byte[]> back;
+        std::vector<std::byte> scratch;
+
+        Size frontSize = 0;
+        Size cursor = 0;
+        Size backSize = 0;
+        Size backFetched = 0;
+        bool backValid = true;
+
+        Size unrequested = 0;
+        Size length = 0;
+        Size base = 0;
+        Size consumed = 0;
+        bool valid = true;
+
+        std::mutex mutex;
+        std::condition_variable_any condition;
+        bool requested = false;
+        std::jthread worker;
+
+        void Work(std::stop_token stop)
+        {
+            while (true)
+            {
+                {
+                    std::unique_lock lock(mutex);
+                    if (!condition.wait(lock, stop, [&] { return requested; })) return;
+                }
+
+                Size start = 0;
+                if constexpr (AlignableStream<Underlying>) start = streams::Offset(stream);
+
+                streams::Read(stream, back.get(), backSize);
+
+                auto filled = true;
+                if constexpr (requires { stream.Valid(); }) filled = stream.Valid();
+
+                auto fetched = backSize;
+                if constexpr (AlignableStream<Underlying>)
+                {
+                    if (!filled) fetched = std::clamp(streams::Offset(stream) - start, Size(0), backSize);
+                }
+
+                {
+                    std::scoped_lock lock(mutex);
+                    backFetched = fetched;
+                    backValid = filled;
+                    requested = false;
+                }
+                condition.notify_all();
+            }
+        }
+
+        void Wait()
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&] { return !requested; });
+        }
+
+        void Schedule()
+        {
+            if constexpr (SizedStream<Underlying>)
+            {
+                backSize = std::min(capacity, unrequested);
+                unrequested -= backSize;
+            }
+            else backSize = capacity;
+
+            if (backSize == 0) return;
+
+            {
+                std::scoped_lock lock(mutex);
+                requested = true;
+            }
+            condition.notify_all();
+        }
+
+        bool Swap()
+        {
+            Wait();
+            if (backSize == 0) return false;
+
+            std::swap(front, back);
+            frontSize = std::exchange(backFetched, 0);
+            backSize = 0;
+            cursor = 0;
+
+            // A short fill ends the data, so nothing further is requested
+            if (backValid) Schedule();
+            return frontSize > 0;
+        }
+    };
+
+    template<InputStream Underlying>
+    PrefetchingInputStream(Underlying&&) -> PrefetchingInputStream<Underlying>;
+
+    template<InputStream Underlying>
+    PrefetchingInputStream(Underlying&&, Size) -> PrefetchingInputStream<Underlying>;
+
+    static_assert(PointerInputStream<PrefetchingInputStream<InputStreamArchetype>>, "PrefetchingInputStream must be PointerInputStream");
+    static_assert(SizedStream<PrefetchingInputStream<CombinedArchetype<SizedStreamArchetype, InputStreamArchetype>>>, "PrefetchingInputStream must be SizedStream");
+    static_assert(AlignableStream<PrefetchingInputStream<CombinedArchetype<AlignableStreamArchetype, InputStreamArchetype>>>, "PrefetchingInputStream must be AlignableStream");
+
+    struct PrefetchFunctor : functional::ExtensionMethod
+    {
+        template<InputStream Underlying>
+        auto operator()(Underlying&& stream, Size capacity = PrefetchingInputStream<Underlying>::DefaultCapacity) const
+        {
+            return PrefetchingInputStream<Underlying>(std::forward<Underlying>(stream), capacity);
+        }
+    };
+    inline constexpr PrefetchFunctor Prefetch;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <MyakishLibrary/Streams/Common.hpp>
+#include <MyakishLibrary/Streams/Native.hpp>
+
+namespace myakish::streams
+{
+    class ChunkPool
+    {
+    public:
+
+        using Chunk = std::unique_ptr<std::byte[]>;
+
+        inline constexpr static Size DefaultChunkSize = 1 << 20;
+
+        explicit ChunkPool(Size chunkSize = DefaultChunkSize, std::size_t maxRetained = 64) : chunkSize(chunkSize), maxRetained(maxRetained) {}
+
+        Size ChunkSize() const
+        {
+            return chunkSize;
+        }
+
+        Chunk Acquire()
+        {
+            {
+                std::scoped_lock lock(mutex);
+
+                if (!free.empty())
+                {
+                    auto chunk = std::move(free.back());
+                    free.pop_back();
+                    return chunk;
+                }
+            }
+
+            return std::make_unique_for_overwrite<std::byte[]>(chunkSize);
+        }
+
+        void Release(Chunk chunk)
+        {
+            std::scoped_lock lock(mutex);
+
+            if (free.size() < maxRetained) free.push_back(std::move(chunk));
+        }
+
+        static ChunkPool& Default()
+        {
+            static ChunkPool pool;
+            return pool;
+        }
+
+    private:
+
+        Size chunkSize;
+        std::size_t maxRetained;
+
+        std::mutex mutex;
+        std::vector<Chunk> free;
+    };
+
+    class SegmentedOutputStream
+    {
+        struct Segment
+        {
+            ChunkPool::Chunk storage;
+            Size length;
+            Size capacity;
+        };
+
+        ChunkPool* pool;
+        std::vector<Segment> segments;
+        Size total;
+
+    public:
+
+        SegmentedOutputStream(ChunkPool& pool = ChunkPool::Default()) : pool(&pool), total(0) {}
+
+        SegmentedOutputStream(SegmentedOutputStream&& rhs) noexcept : pool(rhs.pool), segments(std::move(rhs.segments)), total(std::exchange(rhs.total, 0)) {}
+        SegmentedOutputStream(const SegmentedOutputStream&) = delete;
+
+        ~SegmentedOutputStream()
+        {
+            Clear();
+        }
+
+        std::byte* Write(Size size)
+        {
+            if (segments.empty() || Available() < size) Append(size);
+
+            auto& last = segments.back();
+            total += size;
+
+            return last.storage.get() + std::exchange(last.length, last.length + size);
+        }
+
+        // Acquired regions are never split across segments
+        std::span<std::byte> Acquire(Size size)
+        {
+            if (segments.empty() || Available() < size) Append(size);
+
+            auto& last = segments.back();
+            return { last.storage.get() + last.length, static_cast<std::size_t>(size) };
+        }
+
+        void Commit(Size used)
+        {
+            segments.back().length += used;
+            total += used;
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            while (size > 0)
+            {
+                if (segments.empty() || Available() == 0) Append(0);
+
+                auto& last = segments.back();
+                auto count = std::min(size, last.capacity - last.length);
+
+                std::memcpy(last.storage.get() + last.length, src, count);
+                last.length += count;
+                total += count;
+
+                src += count;
+                size -= count;
+            }
+        }
+
+        void Seek(Size size)
+        {
+            while (size > 0)
+            {
+                if (segments.empty() || Available() == 0) Append(0);
+
+                auto& last = segments.back();
+                auto count = std::min(size, last.capacity - last.length);
+
+                std::memset(last.storage.get() + last.length, 0, count);
+                last.length += count;
+                total += count;
+
+                size -= count;
+            }
+        }
+
+        Size Offset() const
+        {
+            return total;
+        }
+
+        auto Segments() const
+        {
+            return segments | std::views::transform([](const Segment& segment)
+                {
+                    return std::span<const std::byte>(segment.storage.get(), static_cast<std::size_t>(segment.length));
+                });
+        }
+
+        ByteBuffer Linearize() const
+        {
+            BufferOutputStream out(total);
+
+            for (auto segment : Segments()) out.Write(segment.data(), static_cast<Size>(segment.size()));
+
+            return out.Release();
+        }
+
+        bool Flush(NativeFile& file) const
+        {
+            auto buffers = Segments() | std::ranges::to<std::vector>();
+
+            return file.WriteGather(buffers) == total;
+        }
+
+        void Clear()
+        {
+            for (auto& segment : segments)
+                if (segment.capacity == pool->ChunkSize()) pool->Release(std::move(segment.storage));
+
+            segments.clear();
+            total = 0;
+        }
+
+    private:
+
+        Size Available() const
+        {
+            return segments.back().capacity - segments.back().length;
+        }
+
+        void Append(Size required)
+        {
+            if (required > pool->ChunkSize())
+            {
+                segments.push_back({ std::make_unique_for_overwrite<std::byte[]>(required), 0, required });
+                return;
+            }
+
+            segments.push_back({ pool->Acquire(), 0, pool->ChunkSize() });
+        }
+    };
+    static_assert(PointerOutputStream<SegmentedOutputStream>, "SegmentedOutputStream must be PointerOutputStream");
+    static_assert(TransactionalStream<SegmentedOutputStream>, "SegmentedOutputStream must be TransactionalStream");
+    static_assert(AlignableStream<SegmentedOutputStream>, "SegmentedOutputStream must be AlignableStream");
+
+    // Writes of at least `threshold` bytes are referenced, not copied: their sources must outlive Flush
+    class GatherOutputStream
+    {
+        ChunkPool* pool;
+        std::vector<ChunkPool::Chunk> chunks;
+        std::vector<std::unique_ptr<std::byte[]>> oversized;
+        std::vector<std::span<const std::byte>> pieces;
+        Size used;
+        Size threshold;
+        Size total;
+
+    public:
+
+        inline constexpr static Size DefaultThreshold = 4096;
+
+        GatherOutputStream(Size threshold = DefaultThreshold, ChunkPool& pool = ChunkPool::Default()) : pool(&pool), used(0), threshold(threshold), total(0) {}
+
+        GatherOutputStream(GatherOutputStream&& rhs) noexcept :
+            pool(rhs.pool), chunks(std::move(rhs.chunks)), oversized(std::move(rhs.oversized)), pieces(std::move(rhs.pieces)),
+            used(std::exchange(rhs.used, 0)), threshold(rhs.threshold), total(std::exchange(rhs.total, 0)) {}
+        GatherOutputStream(const GatherOutputStream&) = delete;
+
+        ~GatherOutputStream()
+        {
+            Clear();
+        }
+
+        std::byte* Write(Size size)
+        {
+            if (size > pool->ChunkSize())
+            {
+                auto& storage = oversized.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size));
+                pieces.emplace_back(storage.get(), static_cast<std::size_t>(size));
+
+                total += size;
+                return storage.get();
+            }
+
+            if (chunks.empty() || used + size > pool->ChunkSize())
+            {
+                chunks.push_back(pool->Acquire());
+                used = 0;
+            }
+
+            auto at = chunks.back().get() + used;
+
+            if (!pieces.empty() && pieces.back().data() + pieces.back().size() == at)
+                pieces.back() = { pieces.back().data(), pieces.back().size() + static_cast<std::size_t>(size) };
+            else
+                pieces.emplace_back(at, static_cast<std::size_t>(size));
+
+            used += size;
+            total += size;
+            return at;
+        }
+
+        void Write(const std::byte* src, Size size)
+        {
+            if (size < threshold)
+            {
+                std::memcpy(Write(size), src, size);
+                return;
+            }
+
+            pieces.emplace_back(src, static_cast<std::size_t>(size));
+            total += size;
+        }
+
+        void Seek(Size size)
+        {
+            std::memset(Write(size), 0, size);
+        }
+
+        Size Offset() const
+        {
+            return total;
+        }
+
+        std::span<const std::span<const std::byte>> Pieces() const
+        {
+            return pieces;
+        }
+
+        bool Flush(NativeFile& file) const
+        {
+            return file.WriteGather(pieces) == total;
+        }
+
+        void Clear()
+        {
+            for (auto& chunk : chunks) pool->Release(std::move(chunk));
+
+            chunks.clear();
+            oversized.clear();
+            pieces.clear();
+            used = 0;
+            total = 0;
+        }
+    };
+    static_assert(PointerOutputStream<GatherOutputStream>, "GatherOutputStream must be PointerOutputStream");
+    static_assert(AlignableStream<GatherOutputStream>, "GatherOutputStream must be AlignableStream");
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <concepts>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
+#include <span>
+#include <vector>
 
 #include <MyakishLibrary/Meta.hpp>
 #include <MyakishLibrary/Core.hpp>
@@ -469,6 +472,93 @@ namespace myakish::streams
 
 
 
+    namespace detail::Acquire
+    {
+        template<typename Stream>
+        concept HasMember = requires(Stream && stream, Size size)
+        {
+            { stream.Acquire(size) } -> std::convertible_to<std::span<std::byte>>;
+            { stream.Commit(size) };
+        };
+
+        template<typename Stream>
+        concept HasADL = requires(Stream && stream, Size size)
+        {
+            { AcquireADL<Stream>(stream, size) } -> std::convertible_to<std::span<std::byte>>;
+            { CommitADL<Stream>(stream, size) };
+        };
+
+        template<typename Stream>
+        consteval static Strategy ChooseStrategy()
+        {
+            using enum Strategy;
+
+            if constexpr (HasMember<Stream>) return Member;
+            else if constexpr (HasADL<Stream>) return ADL;
+            else return None;
+        }
+
+        inline std::vector<std::byte>& Scratch()
+        {
+            thread_local std::vector<std::byte> scratch;
+            return scratch;
+        }
+    }
+
+    // Acquire hands out size writable bytes, Commit publishes the first used of them.
+    // Streams without native support get a per-thread scratch region that Commit copies out,
+    // so only one acquisition per thread may be outstanding on them
+    struct AcquireFunctor : functional::ExtensionMethod
+    {
+        template<OutputStream Stream>
+        std::span<std::byte> operator()(Stream&& stream, Size size) const
+        {
+            constexpr auto Strategy = detail::Acquire::ChooseStrategy<Stream>();
+
+            using enum detail::Strategy;
+
+            if constexpr (Strategy == Member) return stream.Acquire(size);
+            else if constexpr (Strategy == ADL) return AcquireADL<Stream>(stream, size);
+            else
+            {
+                auto& scratch = detail::Acquire::Scratch();
+                if (static_cast<Size>(scratch.size()) < size) scratch.resize(size);
+
+                return { scratch.data(), static_cast<std::size_t>(size) };
+            }
+        }
+    };
+    inline constexpr AcquireFunctor Acquire;
+
+    struct CommitFunctor : functional::ExtensionMethod
+    {
+        template<OutputStream Stream>
+        void operator()(Stream&& stream, Size used) const
+        {
+            constexpr auto Strategy = detail::Acquire::ChooseStrategy<Stream>();
+
+            using enum detail::Strategy;
+
+            if constexpr (Strategy == Member) stream.Commit(used);
+            else if constexpr (Strategy == ADL) CommitADL<Stream>(stream, used);
+            else Write(stream, detail::Acquire::Scratch().data(), used);
+        }
+    };
+    inline constexpr CommitFunctor Commit;
+
+    template<typename Type>
+    concept TransactionalStream = OutputStream<Type> && (detail::Acquire::ChooseStrategy<Type>() != detail::Strategy::None);
+
+    struct TransactionalStreamArchetype : virtual OutputStreamArchetype
+    {
+        std::span<std::byte> Acquire(Size size);
+        void Commit(Size used);
+    };
+    static_assert(TransactionalStream<TransactionalStreamArchetype>);
+
+
+
+
     namespace detail::Data
     {
         template<typename Stream>
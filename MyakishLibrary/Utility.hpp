@@ -149,6 +149,7 @@ namespace myakish
     inline constexpr BitCastFunctor<To> BitCast;
 
 
+    // MurmurHash64A over exactly the bytes of the view
     struct HashFunctor : functional::ExtensionMethod
     {
         constexpr std::uint64_t operator()(std::string_view str) const
@@ -158,44 +159,36 @@ namespace myakish
             constexpr std::uint64_t seed = 700924169573080812ULL;
 
             const std::size_t len = str.size();
-            const std::size_t calclen = len ? len + 1 : 0;
-            std::uint64_t hash = seed ^ (calclen * multiply);
+            std::uint64_t hash = seed ^ (len * multiply);
 
-            if (len > 0)
+            const auto* data = str.data();
+
+            for (std::size_t i = 0; i < len / 8; ++i, data += 8)
             {
-                const auto* data = str.data();
-                const auto first_loop_iterations = calclen / 8;
-
-                for (size_t i = 0; i < first_loop_iterations; ++i)
-                {
-                    std::uint64_t k = BitCast<std::uint64_t>(
-                        *data, *(data + 1), *(data + 2), *(data + 3),
-                        *(data + 4), *(data + 5), *(data + 6), *(data + 7));
-
-                    k *= multiply;
-                    k ^= k >> shift;
-                    k *= multiply;
-
-                    hash ^= k;
-                    hash *= multiply;
-                    data += 8;
-                }
-
-                const auto* data2 = str.data() + 8 * first_loop_iterations;
-
-                switch (calclen & 7)
-                {
-                case 7: hash ^= static_cast<uint64_t>(data2[6]) << 48ULL; [[fallthrough]];
-                case 6: hash ^= static_cast<uint64_t>(data2[5]) << 40ULL; [[fallthrough]];
-                case 5: hash ^= static_cast<uint64_t>(data2[4]) << 32ULL; [[fallthrough]];
-                case 4: hash ^= static_cast<uint64_t>(data2[3]) << 24ULL; [[fallthrough]];
-                case 3: hash ^= static_cast<uint64_t>(data2[2]) << 16ULL; [[fallthrough]];
-                case 2: hash ^= static_cast<uint64_t>(data2[1]) << 8ULL; [[fallthrough]];
-                case 1: hash ^= static_cast<uint64_t>(data2[0]);
-                    hash *= multiply;
-                };
+                std::uint64_t k = BitCast<std::uint64_t>(
+                    data[0], data[1], data[2], data[3],
+                    data[4], data[5], data[6], data[7]);
+
+                k *= multiply;
+                k ^= k >> shift;
+                k *= multiply;
+
+                hash ^= k;
+                hash *= multiply;
             }
 
+            switch (len & 7)
+            {
+            case 7: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[6])) << 48ULL; [[fallthrough]];
+            case 6: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[5])) << 40ULL; [[fallthrough]];
+            case 5: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[4])) << 32ULL; [[fallthrough]];
+            case 4: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[3])) << 24ULL; [[fallthrough]];
+            case 3: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[2])) << 16ULL; [[fallthrough]];
+            case 2: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[1])) << 8ULL; [[fallthrough]];
+            case 1: hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(data[0]));
+                hash *= multiply;
+            };
+
             hash ^= hash >> shift;
             hash *= multiply;
             hash ^= hash >> shift;
@@ -206,11 +199,12 @@ namespace myakish
     inline constexpr HashFunctor Hash;
 
 
+    // Order-sensitive: combining (a, b) and (b, a) gives different hashes
     struct HashCombineFunctor : functional::ExtensionMethod
     {
         constexpr std::uint64_t operator()(std::uint64_t f, std::uint64_t s) const
         {
-            return f ^ s;
+            return f ^ (s + 0x9e3779b97f4a7c15ULL + (f << 12) + (f >> 4));
         }
     };
     inline constexpr HashCombineFunctor HashCombine;